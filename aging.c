@@ -0,0 +1,375 @@
+/**
+ * @file    aging.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Source file for aging.h
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The steady-state window of a trace is the stretch between the first and
+ * the last request at which the live payload is at least half its peak,
+ * which cuts off the ramp-up and the final tear-down. If that stretch is
+ * shorter than a tenth of the trace, the middle half is used instead.
+ *
+ * The requests before the window are replayed once to build the initial
+ * live set. The window is then replayed params->epochs times:
+ *
+ *    - alloc and realloc sizes are scaled by a random factor in
+ *      [1 - size_jitter, 1 + size_jitter]
+ *    - every free is deferred by a random number of requests in
+ *      [0, free_delay], which stretches lifetimes by different amounts
+ *    - an alloc of a block id that is still live, for example one whose
+ *      free was deferred past the end of the window, replaces the old
+ *      block, so the live set stays bounded from pass to pass
+ *
+ * Progress lines show the heap size and the utilization, both current
+ * (live payload / heap size) and peak (largest live payload so far / heap
+ * size, as mdriver reports it). The final line compares the heap size half
+ * way through the run with the heap size at the end.
+ */
+#include "aging.h"
+#include "memlib.h"
+#include "std_wrappers.h"
+
+#include <stdio.h>          // printf, fprintf
+#include <stdlib.h>         // free
+
+
+// =======================
+// Types
+// =======================
+
+typedef struct
+{
+   long     due;         /* request count at which the free happens */
+   int      index;       /* block id                                */
+   unsigned gen;         /* incarnation of the block id             */
+} deferred_t;
+
+typedef struct
+{
+   const allocator_t* alloc;
+   char**             ptrs;
+   int*               sizes;
+   unsigned*          gens;        /* incremented on every alloc of an id */
+   double             live;
+   double             peak;
+
+   deferred_t*        heap;        /* min-heap of deferred frees by due */
+   int                nheap;
+   int                capacity;
+
+   long               clock;       /* requests issued so far            */
+   unsigned           seed;
+} aging_state_t;
+
+
+// ==========================
+// Private Helper Functions
+// ==========================
+
+static unsigned next_rand( aging_state_t* st )
+{
+   st->seed ^= st->seed << 13;
+   st->seed ^= st->seed >> 17;
+   st->seed ^= st->seed << 5;
+
+   return st->seed;
+}
+
+
+/*
+ * uniform - random double in [0, 1)
+ */
+static double uniform( aging_state_t* st )
+{
+   return ( next_rand( st ) >> 8 ) / ( double )( 1u << 24 );
+}
+
+
+static void defer_push( aging_state_t* st, deferred_t d )
+{
+   int i;
+
+   if ( st->nheap == st->capacity )
+   {
+      st->capacity = 2 * st->capacity + 64;
+      st->heap     = ( deferred_t* )Realloc( st->heap, st->capacity * sizeof( deferred_t ) );
+   }
+
+   for ( i = st->nheap++; i > 0 && st->heap[ ( i - 1 ) / 2 ].due > d.due; i = ( i - 1 ) / 2 )
+      st->heap[ i ] = st->heap[ ( i - 1 ) / 2 ];
+
+   st->heap[ i ] = d;
+}
+
+
+static deferred_t defer_pop( aging_state_t* st )
+{
+   deferred_t top  = st->heap[ 0 ];
+   deferred_t last = st->heap[ --st->nheap ];
+   int        i    = 0;
+
+   for ( ;; )
+   {
+      int child = 2 * i + 1;
+
+      if ( child >= st->nheap )
+         break;
+      if ( child + 1 < st->nheap && st->heap[ child + 1 ].due < st->heap[ child ].due )
+         ++child;
+      if ( last.due <= st->heap[ child ].due )
+         break;
+
+      st->heap[ i ] = st->heap[ child ];
+      i             = child;
+   }
+
+   if ( st->nheap > 0 )
+      st->heap[ i ] = last;
+
+   return top;
+}
+
+
+static void release( aging_state_t* st, int index )
+{
+   if ( st->ptrs[ index ] == NULL )
+      return;
+
+   st->alloc->free( st->ptrs[ index ] );
+   st->live          -= st->sizes[ index ];
+   st->ptrs[ index ]  = NULL;
+   st->sizes[ index ] = 0;
+}
+
+
+/*
+ * run_deferred - perform the deferred frees that have come due
+ */
+static void run_deferred( aging_state_t* st )
+{
+   while ( st->nheap > 0 && st->heap[ 0 ].due <= st->clock )
+   {
+      deferred_t d = defer_pop( st );
+
+      if ( st->gens[ d.index ] == d.gen )
+         release( st, d.index );
+   }
+}
+
+
+/*
+ * issue - perform one, possibly perturbed, request
+ *
+ * Return: 0 if the allocator ran out of memory, 1 otherwise
+ */
+static int issue( aging_state_t* st, const trace_op_t* p, const aging_params_t* params, int perturb )
+{
+   int   size = p->size;
+   char* q;
+
+   ++st->clock;
+   run_deferred( st );
+
+   if ( perturb && p->type != FREE )
+   {
+      size = ( int )( size * ( 1.0 + params->size_jitter * ( 2.0 * uniform( st ) - 1.0 ) ) );
+      if ( size < 1 )
+         size = 1;
+   }
+
+   switch ( p->type )
+   {
+      case ALLOC:
+         release( st, p->index );
+         if ( ( q = st->alloc->malloc( size ) ) == NULL )
+            return 0;
+         ++st->gens[ p->index ];
+         st->ptrs[ p->index ]  = q;
+         st->sizes[ p->index ] = size;
+         st->live += size;
+         break;
+
+      case REALLOC:
+         if ( st->ptrs[ p->index ] == NULL )
+            ++st->gens[ p->index ];
+         if ( ( q = st->alloc->realloc( st->ptrs[ p->index ], size ) ) == NULL )
+            return 0;
+         st->live += size - st->sizes[ p->index ];
+         st->ptrs[ p->index ]  = q;
+         st->sizes[ p->index ] = size;
+         break;
+
+      case FREE:
+         if ( perturb && params->free_delay > 0 )
+         {
+            deferred_t d;
+
+            d.due   = st->clock + next_rand( st ) % ( unsigned )( params->free_delay + 1 );
+            d.index = p->index;
+            d.gen   = st->gens[ p->index ];
+            defer_push( st, d );
+         }
+         else
+         {
+            release( st, p->index );
+         }
+         break;
+   }
+
+   if ( st->live > st->peak )
+      st->peak = st->live;
+
+   return 1;
+}
+
+
+/*
+ * find_window - locate the steady-state window [*lo, *hi) of a trace
+ */
+static void find_window( const trace_t* trace, int* lo, int* hi )
+{
+   int*   sizes = ( int* )Calloc( trace->num_ids > 0 ? trace->num_ids : 1, sizeof( int ) );
+   double live  = 0.0;
+   double peak  = 0.0;
+   int    pass;
+   int    i;
+
+   *lo = -1;
+   *hi = -1;
+
+   /* First pass finds the peak, second pass the window around it */
+   for ( pass = 0; pass < 2; ++pass )
+   {
+      live = 0.0;
+      for ( i = 0; i < trace->num_ids; ++i )
+         sizes[ i ] = 0;
+
+      for ( i = 0; i < trace->num_ops; ++i )
+      {
+         const trace_op_t* p = &trace->ops[ i ];
+
+         live -= sizes[ p->index ];
+         sizes[ p->index ] = ( p->type == FREE ) ? 0 : p->size;
+         live += sizes[ p->index ];
+
+         if ( pass == 0 && live > peak )
+            peak = live;
+
+         if ( pass == 1 && live >= peak / 2.0 )
+         {
+            if ( *lo < 0 )
+               *lo = i;
+            *hi = i + 1;
+         }
+      }
+   }
+
+   if ( *lo < 0 || ( *hi - *lo ) < trace->num_ops / 10 || *hi - *lo < 1 )
+   {
+      *lo = trace->num_ops / 4;
+      *hi = trace->num_ops - trace->num_ops / 4;
+   }
+
+   free( sizes );
+}
+
+
+static void report( FILE* series, const allocator_t* alloc, const char* name,
+                    const aging_state_t* st, long epoch )
+{
+   size_t heap = mem_footprint();
+
+   printf( "%12ld %14ld %12.1f %12.1f %7.1f%% %7.1f%%\n", epoch, st->clock, st->live / 1024.0, heap / 1024.0,
+           heap > 0 ? 100.0 * st->live / heap : 0.0, heap > 0 ? 100.0 * st->peak / heap : 0.0 );
+   fflush( stdout );
+
+   if ( series != NULL )
+      fprintf( series, "%s,%s,%ld,%zu,%.0f,%zu\n", alloc->name, name, st->clock, heap, st->live, mem_resident() );
+}
+
+
+// ==========================
+// Public Functions
+// ==========================
+
+/*
+ * age_trace - run the aging simulation of a trace on a fresh heap
+ *
+ * If series is not NULL, a time series row is written with every progress
+ * line, in the format of mdriver -T, with the request count as the op.
+ *
+ * Return: 1 if all epochs completed, 0 if the allocator ran out of memory
+ */
+int age_trace( const allocator_t* alloc, const trace_t* trace, const char* name,
+               const aging_params_t* params, FILE* series )
+{
+   aging_state_t st     = { 0 };
+   long          every  = params->epochs / ( params->reports > 0 ? params->reports : 1 );
+   size_t        half   = 0;
+   int           ok     = 1;
+   long          epoch;
+   int           lo;
+   int           hi;
+   int           i;
+
+   if ( !alloc->uses_memlib )
+      app_error( "mdriver: aging needs an allocator that uses memlib" );
+
+   if ( every < 1 )
+      every = 1;
+
+   st.alloc = alloc;
+   st.ptrs  = ( char** )Calloc( trace->num_ids > 0 ? trace->num_ids : 1, sizeof( char* ) );
+   st.sizes = ( int* )Calloc( trace->num_ids > 0 ? trace->num_ids : 1, sizeof( int ) );
+   st.gens  = ( unsigned* )Calloc( trace->num_ids > 0 ? trace->num_ids : 1, sizeof( unsigned ) );
+   st.seed  = params->seed ? params->seed : 1;
+
+   mem_reset_brk();
+   if ( alloc->init() < 0 )
+      app_error( "mdriver: allocator init failed" );
+
+   find_window( trace, &lo, &hi );
+
+   printf( "\n%s: aging %ld epochs of requests [%d, %d), size jitter %.0f%%, free delay <= %d requests\n",
+           name, params->epochs, lo, hi, 100.0 * params->size_jitter, params->free_delay );
+   printf( "%12s %14s %12s %12s %8s %8s\n", "epoch", "requests", "live KB", "heap KB", "util", "peak" );
+
+   for ( i = 0; i < lo && ok; ++i )
+      ok = issue( &st, &trace->ops[ i ], params, 0 );
+
+   for ( epoch = 1; epoch <= params->epochs && ok; ++epoch )
+   {
+      for ( i = lo; i < hi && ok; ++i )
+         ok = issue( &st, &trace->ops[ i ], params, 1 );
+
+      if ( epoch == params->epochs / 2 )
+         half = mem_footprint();
+
+      if ( ok && ( epoch % every == 0 || epoch == params->epochs ) )
+         report( series, alloc, name, &st, epoch );
+   }
+
+   if ( !ok )
+   {
+      report( series, alloc, name, &st, epoch - 1 );
+      printf( "%s: allocator ran out of memory after %ld epochs: footprint is not bounded\n", name, epoch - 1 );
+   }
+   else if ( half > 0 )
+   {
+      printf( "%s: heap drift over the second half: %+.2f%% (%zu -> %zu bytes)\n", name,
+              100.0 * ( ( double )mem_footprint() - half ) / half, half, mem_footprint() );
+   }
+
+   for ( i = 0; i < trace->num_ids; ++i )
+      release( &st, i );
+
+   free( st.heap );
+   free( st.gens );
+   free( st.sizes );
+   free( st.ptrs );
+
+   return ok;
+}
\ No newline at end of file
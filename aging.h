@@ -0,0 +1,36 @@
+/**
+ * @file    aging.h
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Long-running heap aging simulation over a trace
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Fragmentation that builds up over days is invisible in a single replay.
+ * age_trace() replays the steady-state phase of a trace over and over,
+ * with the request sizes and the lifetimes of blocks randomly perturbed so
+ * that no two passes are identical, and tracks the heap size and the
+ * utilization as the passes accumulate.
+ */
+#ifndef __2026_10_18_AGING_H__
+#define __2026_10_18_AGING_H__
+
+#include "allocators.h"
+#include "trace.h"
+
+#include <stdio.h>             // FILE
+
+typedef struct
+{
+   long     epochs;        /* passes over the steady-state window            */
+   double   size_jitter;   /* sizes are scaled by up to +/- this fraction    */
+   int      free_delay;    /* frees are deferred by up to this many requests */
+   unsigned seed;
+   int      reports;       /* progress lines printed over the run            */
+} aging_params_t;
+
+int age_trace( const allocator_t* alloc, const trace_t* trace, const char* name,
+               const aging_params_t* params, FILE* series );
+
+#endif  // __2026_10_18_AGING_H__
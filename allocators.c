@@ -0,0 +1,120 @@
+/**
+ * @file    allocators.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Source file for allocators.h
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include "allocators.h"
+#include "mm.h"
+#include "partition.h"
+#include "side.h"
+#include "skip.h"
+#include "slab.h"
+
+#include <stdlib.h>         // free, malloc, realloc
+#include <string.h>         // strcmp
+
+
+// ==========================
+// libc Adapters
+// ==========================
+
+static int libc_init( void )
+{
+   return 0;
+}
+
+
+// ==========================
+// mm Adapters
+// ==========================
+
+static int mm_first_init( void )
+{
+   mm_set_wilderness( 0 );
+   return mm_init();
+}
+
+
+static int mm_wild_init( void )
+{
+   mm_set_wilderness( 1 );
+   return mm_init();
+}
+
+
+// ==========================
+// slab Adapters
+// ==========================
+
+static int slab_color_init( void )
+{
+   slab_set_coloring( 1 );
+   return slab_init();
+}
+
+
+static int slab_plain_init( void )
+{
+   slab_set_coloring( 0 );
+   return slab_init();
+}
+
+
+// ==========================
+// side Adapters
+// ==========================
+
+static int side_init16( void )
+{
+   side_set_granule( 16 );
+   return side_init();
+}
+
+
+static int side_init64( void )
+{
+   side_set_granule( 64 );
+   return side_init();
+}
+
+
+// ==========================
+// Allocator Table
+// ==========================
+
+const allocator_t allocators[] =
+{
+   { "mm",           "implicit free list over memlib (mm.c)",                        1, mm_first_init,   mm_malloc,   mm_free,   mm_realloc   },
+   { "mm-wild",      "mm, top block split only when nothing else fits",              1, mm_wild_init,    mm_malloc,   mm_free,   mm_realloc   },
+   { "slab",         "slab allocator with cache coloring (slab.c)",                  1, slab_color_init, slab_malloc, slab_free, slab_realloc },
+   { "slab-nocolor", "slab allocator, every slab at offset 0",                       1, slab_plain_init, slab_malloc, slab_free, slab_realloc },
+   { "skip",         "address-ordered first fit, skip list of free blocks (skip.c)", 1, skip_init,       skip_malloc, skip_free, skip_realloc },
+   { "partition",    "one memlib region per size class, no headers (partition.c)",   1, part_init,       part_malloc, part_free, part_realloc },
+   { "side",         "block boundaries in side bitmaps (side.c)",                    1, side_init16,     side_malloc, side_free, side_realloc },
+   { "side-cl",      "side bitmaps, cache line aligned payloads",                    1, side_init64,     side_malloc, side_free, side_realloc },
+   { "libc",         "system malloc",                                                0, libc_init,       malloc,      free,      realloc      },
+   { NULL,           NULL,                                                           0, NULL,            NULL,        NULL,      NULL         }
+};
+
+
+/*
+ * find_allocator - look up an allocator by name
+ *
+ * Return: the table entry, or NULL if there is no allocator of that name
+ */
+const allocator_t* find_allocator( const char* name )
+{
+   const allocator_t* a;
+
+   for ( a = allocators; a->name != NULL; ++a )
+   {
+      if ( strcmp( a->name, name ) == 0 )
+         return a;
+   }
+
+   return NULL;
+}
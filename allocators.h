@@ -0,0 +1,34 @@
+/**
+ * @file    allocators.h
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Table of the allocators the benchmark tools can drive
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Allocators that carve their heap out of memlib set uses_memlib; the tools
+ * reset the memlib break and call init() before every run of those, and
+ * only for those report heap size and utilization.
+ */
+#ifndef __2026_10_18_ALLOCATORS_H__
+#define __2026_10_18_ALLOCATORS_H__
+
+#include <stddef.h>            // size_t
+
+typedef struct
+{
+   const char* name;
+   const char* description;
+   int         uses_memlib;
+   int         ( *init )( void );
+   void*       ( *malloc )( size_t size );
+   void        ( *free )( void* ptr );
+   void*       ( *realloc )( void* ptr, size_t size );
+} allocator_t;
+
+extern const allocator_t allocators[];      /* terminated by a NULL name */
+
+const allocator_t* find_allocator( const char* name );
+
+#endif  // __2026_10_18_ALLOCATORS_H__
@@ -0,0 +1,178 @@
+/**
+ * @file    bench.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Source file for bench.h
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include "bench.h"
+#include "allocators.h"
+#include "memlib.h"
+#include "std_wrappers.h"
+
+#include <pthread.h>        // pthread_mutex_t, pthread_mutex_lock
+#include <stdio.h>          // printf, fprintf, snprintf
+#include <stdlib.h>         // atoi, exit
+
+#include <unistd.h>         // getopt, optarg, sysconf
+
+
+// ==========================
+// Private Global Variables
+// ==========================
+
+static const char*        alloc_name  = "mm";
+static const allocator_t* alloc       = NULL;
+static int                max_threads = 0;       /* 0: number of online cpus */
+static int                locked      = 0;       /* serialize allocator calls */
+static pthread_mutex_t    lock        = PTHREAD_MUTEX_INITIALIZER;
+
+
+// ==========================
+// Public Functions
+// ==========================
+
+/*
+ * bench_getopt - getopt over the shared options plus the benchmark's own
+ *
+ * Return: the next option that is not a shared one, or -1 when done
+ */
+int bench_getopt( int argc, char* argv[], const char* options )
+{
+   char optstring[ 128 ];
+   int  c;
+
+   snprintf( optstring, sizeof( optstring ), "a:t:%s", options );
+
+   while ( ( c = getopt( argc, argv, optstring ) ) != -1 )
+   {
+      switch ( c )
+      {
+         case 'a':
+            alloc_name = optarg;
+            break;
+         case 't':
+            max_threads = atoi( optarg );
+            break;
+         default:
+            return c;
+      }
+   }
+
+   return -1;
+}
+
+
+/*
+ * bench_usage - print the usage message of a benchmark
+ *
+ * options lists the benchmark's own options for the synopsis and help
+ * describes them, one per line.
+ */
+void bench_usage( const char* prog, const char* options, const char* help )
+{
+   const allocator_t* a;
+
+   fprintf( stderr, "usage: %s [-h] [-a <allocator>] [-t <max threads>] %s\n", prog, options );
+   fprintf( stderr, "  -a <allocator>    allocator to benchmark (default mm)\n" );
+   fprintf( stderr, "  -t <max threads>  largest thread count (default: online cpus)\n" );
+   fprintf( stderr, "%s", help );
+   fprintf( stderr, "  -h                print this message\n" );
+   fprintf( stderr, "allocators:\n" );
+   for ( a = allocators; a->name != NULL; ++a )
+      fprintf( stderr, "  %-16s %s\n", a->name, a->description );
+}
+
+
+/*
+ * bench_setup - select the allocator and initialize memlib
+ */
+void bench_setup( void )
+{
+   if ( ( alloc = find_allocator( alloc_name ) ) == NULL )
+      app_error( "bench: unknown allocator" );
+
+   if ( max_threads <= 0 )
+      max_threads = ( int )sysconf( _SC_NPROCESSORS_ONLN );
+   if ( max_threads <= 0 )
+      max_threads = 1;
+
+   locked = alloc->uses_memlib;
+   mem_init();
+}
+
+
+/*
+ * bench_malloc - allocate from the selected allocator; exits if it runs out of memory
+ */
+void* bench_malloc( size_t size )
+{
+   void* p;
+
+   if ( locked )
+   {
+      pthread_mutex_lock( &lock );
+      p = alloc->malloc( size );
+      pthread_mutex_unlock( &lock );
+   }
+   else
+   {
+      p = alloc->malloc( size );
+   }
+
+   if ( p == NULL )
+      app_error( "bench: allocator out of memory" );
+
+   return p;
+}
+
+
+void bench_free( void* ptr )
+{
+   if ( !locked )
+   {
+      alloc->free( ptr );
+      return;
+   }
+
+   pthread_mutex_lock( &lock );
+   alloc->free( ptr );
+   pthread_mutex_unlock( &lock );
+}
+
+
+/*
+ * bench_scaling - run a benchmark at increasing thread counts
+ */
+void bench_scaling( const char* title, bench_fn_t run )
+{
+   double base = 0.0;
+   int    n;
+
+   printf( "%s: allocator %s (%s)%s\n", title, alloc->name, alloc->description,
+           locked ? ", serialized by a global lock" : "" );
+   printf( "%8s %10s %12s %8s\n", "threads", "secs", "Mops/s", "speedup" );
+
+   for ( n = 1; n <= max_threads; n = ( n < max_threads && 2 * n > max_threads ) ? max_threads : 2 * n )
+   {
+      bench_result_t r;
+      double         tput;
+
+      if ( alloc->uses_memlib )
+         mem_reset_brk();
+      if ( alloc->init() < 0 )
+         app_error( "bench: allocator init failed" );
+
+      r    = run( n );
+      tput = r.secs > 0.0 ? r.ops / r.secs : 0.0;
+      if ( n == 1 )
+         base = tput;
+
+      printf( "%8d %10.3f %12.3f %8.2f\n", n, r.secs, tput / 1e6, base > 0.0 ? tput / base : 0.0 );
+      fflush( stdout );
+   }
+
+   mem_deinit();
+}
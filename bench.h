@@ -0,0 +1,58 @@
+/**
+ * @file    bench.h
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Shared harness for the multithreaded allocator stress benchmarks
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The benchmarks allocate through bench_malloc() and bench_free(), which
+ * forward to an allocator from the allocators table. memlib and the
+ * allocators built on it are not thread-safe, so calls into those are
+ * serialized by a global lock; the benchmarks therefore show what that
+ * lock costs as threads are added.
+ *
+ * bench_getopt() handles the options every benchmark shares, -a <allocator>
+ * and -t <max threads>, and returns the others to the caller. Then
+ * bench_scaling() runs the benchmark with 1, 2, 4, ... up to the maximum
+ * number of threads, on a fresh heap each time, and prints throughput and
+ * speedup over one thread.
+ */
+#ifndef __2026_10_18_BENCH_H__
+#define __2026_10_18_BENCH_H__
+
+#include <stddef.h>            // size_t
+
+typedef struct
+{
+   double ops;       /* operations completed by all threads */
+   double secs;      /* wall clock time they took           */
+} bench_result_t;
+
+typedef bench_result_t ( *bench_fn_t )( int nthreads );
+
+int   bench_getopt( int argc, char* argv[], const char* options );
+void  bench_usage( const char* prog, const char* options, const char* help );
+void  bench_setup( void );
+
+void* bench_malloc( size_t size );
+void  bench_free( void* ptr );
+
+void  bench_scaling( const char* title, bench_fn_t run );
+
+/*
+ * bench_rand - xorshift pseudo random numbers with caller-owned state
+ */
+static inline unsigned bench_rand( unsigned* state )
+{
+   unsigned x = *state;
+
+   x ^= x << 13;
+   x ^= x >> 17;
+   x ^= x << 5;
+
+   return *state = x;
+}
+
+#endif  // __2026_10_18_BENCH_H__
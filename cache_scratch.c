@@ -0,0 +1,130 @@
+/**
+ * @file    cache_scratch.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Hoard cache-scratch benchmark: passive false sharing
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Source:  Berger et al., "Hoard: A Scalable Memory Allocator for
+ *          Multithreaded Applications", ASPLOS 2000
+ *
+ * The main thread allocates one small object per thread back to back, so
+ * they share cache lines, and hands one to each thread. Every thread
+ * frees its object and then repeatedly allocates an object of the same
+ * size, writes it many times and frees it. An allocator that gives the
+ * freed neighbouring memory back to a different thread makes the threads
+ * write to the same cache lines, and the benchmark stops scaling.
+ *
+ * usage: cache-scratch [-h] [-a <allocator>] [-t <max threads>]
+ *                      [-i <iterations>] [-r <repetitions>] [-s <size>]
+ */
+#include "bench.h"
+#include "ftimer.h"
+#include "std_wrappers.h"
+
+#include <pthread.h>        // pthread_t
+#include <stdlib.h>         // atoi, exit, free
+
+#include <unistd.h>         // optarg
+
+
+// ==========================
+// Private Global Variables
+// ==========================
+
+static int iterations  = 1000;
+static int repetitions = 2000;
+static int objsize     = 8;
+static int per_thread;
+
+
+// ==========================
+// Private Helper Functions
+// ==========================
+
+static void* worker( void* arg )
+{
+   int i;
+   int r;
+   int j;
+
+   bench_free( arg );
+
+   for ( i = 0; i < per_thread; ++i )
+   {
+      volatile char* obj = bench_malloc( objsize );
+
+      for ( r = 0; r < repetitions; ++r )
+         for ( j = 0; j < objsize; ++j )
+            obj[ j ] = ( char )( obj[ j ] + 1 );
+
+      bench_free( ( void* )obj );
+   }
+
+   return NULL;
+}
+
+
+static bench_result_t run( int nthreads )
+{
+   pthread_t*     tids = ( pthread_t* )Calloc( nthreads, sizeof( pthread_t ) );
+   void**         objs = ( void** )Calloc( nthreads, sizeof( void* ) );
+   bench_result_t res;
+   double         start;
+   int            t;
+
+   per_thread = iterations / nthreads;
+
+   for ( t = 0; t < nthreads; ++t )
+      objs[ t ] = bench_malloc( objsize );
+
+   start = ftimer_now();
+
+   for ( t = 0; t < nthreads; ++t )
+      Pthread_create( &tids[ t ], NULL, worker, objs[ t ] );
+   for ( t = 0; t < nthreads; ++t )
+      Pthread_join( tids[ t ], NULL );
+
+   res.secs = ftimer_now() - start;
+   res.ops  = ( double )per_thread * nthreads * repetitions;
+
+   free( objs );
+   free( tids );
+   return res;
+}
+
+
+int main( int argc, char* argv[] )
+{
+   const char* options = "[-i <iterations>] [-r <repetitions>] [-s <size>]";
+   const char* help    = "  -i <iterations>   objects allocated, divided among the threads (default 1000)\n"
+                         "  -r <repetitions>  writes to every byte of an object (default 2000)\n"
+                         "  -s <size>         object size in bytes (default 8)\n";
+   int         c;
+
+   while ( ( c = bench_getopt( argc, argv, "hi:r:s:" ) ) != -1 )
+   {
+      switch ( c )
+      {
+         case 'i': iterations  = atoi( optarg ); break;
+         case 'r': repetitions = atoi( optarg ); break;
+         case 's': objsize     = atoi( optarg ); break;
+         case 'h':
+            bench_usage( argv[ 0 ], options, help );
+            exit( EXIT_SUCCESS );
+         default:
+            bench_usage( argv[ 0 ], options, help );
+            exit( EXIT_FAILURE );
+      }
+   }
+
+   if ( iterations < 1 || repetitions < 1 || objsize < 1 )
+      app_error( "cache-scratch: invalid parameters" );
+
+   bench_setup();
+   bench_scaling( "cache-scratch", run );
+
+   return EXIT_SUCCESS;
+}
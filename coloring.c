@@ -0,0 +1,201 @@
+/**
+ * @file    coloring.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Cache coloring benchmark: hot fields of objects in different slabs
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Allocates a number of equal-sized objects and repeatedly increments the
+ * first word of each, a hot field, as cache-thrash does for a single
+ * object. If every slab starts its objects at the same page offset, the
+ * hot fields of all slabs fall into the few L1 cache sets selected by
+ * those offsets and evict each other long before the cache is full.
+ *
+ * For every object count the benchmark reports the number of distinct
+ * L1D sets the hot fields map to, assuming 64 byte lines and 64 sets
+ * (a 32 KB 8-way cache), and the time per access. Each allocator named
+ * with -a is measured; by default slab-nocolor and slab are compared.
+ *
+ * usage: coloring [-h] [-a <allocator>]... [-s <size>] [-p <passes>]
+ */
+#include "allocators.h"
+#include "ftimer.h"
+#include "memlib.h"
+#include "std_wrappers.h"
+
+#include <stdint.h>         // uintptr_t
+#include <stdio.h>          // printf, fprintf
+#include <stdlib.h>         // atoi, exit, free
+
+#include <unistd.h>         // getopt, optarg
+
+
+// =======================
+// Constants and Macros
+// =======================
+
+#define MAX_ALLOCATORS 8
+#define LINE_SHIFT     6            /* 64 byte cache lines */
+#define L1_SETS        64
+#define ACCESSES       ( 1 << 24 )  /* hot field updates per measurement */
+
+
+// ==========================
+// Private Global Variables
+// ==========================
+
+static const int counts[] = { 16, 32, 64, 128, 256, 512, 1024, 4096 };
+
+static int size = 1024;
+
+
+// ==========================
+// Private Helper Functions
+// ==========================
+
+/*
+ * distinct_sets - number of L1D sets the first words of the objects map to
+ */
+static int distinct_sets( char** objs, int n )
+{
+   char used[ L1_SETS ] = { 0 };
+   int  sets = 0;
+   int  i;
+
+   for ( i = 0; i < n; ++i )
+   {
+      int set = ( int )( ( ( uintptr_t )objs[ i ] >> LINE_SHIFT ) % L1_SETS );
+
+      if ( !used[ set ] )
+      {
+         used[ set ] = 1;
+         ++sets;
+      }
+   }
+
+   return sets;
+}
+
+
+/*
+ * hot_fields - increment the first word of every object, passes times
+ *
+ * Return: ns per access
+ */
+static double hot_fields( char** objs, int n, int passes )
+{
+   double t = ftimer_now();
+   int    p;
+   int    i;
+
+   for ( p = 0; p < passes; ++p )
+      for ( i = 0; i < n; ++i )
+         ++*( volatile long* )objs[ i ];
+
+   return 1e9 * ( ftimer_now() - t ) / ( ( double )passes * n );
+}
+
+
+static void run( const allocator_t* alloc, int passes )
+{
+   unsigned k;
+
+   printf( "\n%s: %s, %d byte objects\n", alloc->name, alloc->description, size );
+   printf( "%10s %10s %12s\n", "objects", "L1 sets", "ns/access" );
+
+   for ( k = 0; k < sizeof( counts ) / sizeof( counts[ 0 ] ); ++k )
+   {
+      int    n    = counts[ k ];
+      char** objs = ( char** )Malloc( n * sizeof( char* ) );
+      int    p    = passes > 0 ? passes : ACCESSES / n;
+      int    i;
+
+      mem_reset_brk();
+      if ( alloc->init() < 0 )
+         app_error( "coloring: allocator init failed" );
+
+      for ( i = 0; i < n; ++i )
+      {
+         if ( ( objs[ i ] = alloc->malloc( size ) ) == NULL )
+            app_error( "coloring: allocator returned NULL" );
+         *( long* )objs[ i ] = 0;
+      }
+
+      hot_fields( objs, n, 1 );       /* warm up */
+      printf( "%10d %10d %12.2f\n", n, distinct_sets( objs, n ), hot_fields( objs, n, p ) );
+
+      for ( i = 0; i < n; ++i )
+         alloc->free( objs[ i ] );
+      free( objs );
+   }
+}
+
+
+static void usage( const char* prog )
+{
+   const allocator_t* a;
+
+   fprintf( stderr, "usage: %s [-h] [-a <allocator>]... [-s <size>] [-p <passes>]\n", prog );
+   fprintf( stderr, "  -a <allocator>  allocator to benchmark, may be repeated (default slab-nocolor and slab)\n" );
+   fprintf( stderr, "  -s <size>       object size in bytes (default 1024)\n" );
+   fprintf( stderr, "  -p <passes>     passes over the objects (default: %d accesses in total)\n", ACCESSES );
+   fprintf( stderr, "  -h              print this message\n" );
+   fprintf( stderr, "allocators:\n" );
+   for ( a = allocators; a->name != NULL; ++a )
+      fprintf( stderr, "  %-14s %s\n", a->name, a->description );
+}
+
+
+int main( int argc, char* argv[] )
+{
+   const allocator_t* allocs[ MAX_ALLOCATORS ];
+   int                nallocs = 0;
+   int                passes  = 0;
+   int                c;
+   int                i;
+
+   while ( ( c = getopt( argc, argv, "ha:s:p:" ) ) != -1 )
+   {
+      switch ( c )
+      {
+         case 'a':
+            if ( nallocs == MAX_ALLOCATORS || ( allocs[ nallocs++ ] = find_allocator( optarg ) ) == NULL )
+            {
+               usage( argv[ 0 ] );
+               exit( EXIT_FAILURE );
+            }
+            break;
+         case 's': size   = atoi( optarg ); break;
+         case 'p': passes = atoi( optarg ); break;
+         case 'h':
+            usage( argv[ 0 ] );
+            exit( EXIT_SUCCESS );
+         default:
+            usage( argv[ 0 ] );
+            exit( EXIT_FAILURE );
+      }
+   }
+
+   if ( size < ( int )sizeof( long ) || passes < 0 )
+      app_error( "coloring: invalid parameters" );
+
+   if ( nallocs == 0 )
+   {
+      allocs[ nallocs++ ] = find_allocator( "slab-nocolor" );
+      allocs[ nallocs++ ] = find_allocator( "slab" );
+   }
+
+   mem_init();
+
+   for ( i = 0; i < nallocs; ++i )
+   {
+      if ( !allocs[ i ]->uses_memlib )
+         app_error( "coloring: the allocators must use memlib" );
+      run( allocs[ i ], passes );
+   }
+
+   mem_deinit();
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file    ftimer.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Source file for ftimer.h
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    Adapted from CSAPP.
+ */
+#include "ftimer.h"
+#include "std_wrappers.h"
+
+#include <time.h>           // clock_gettime, CLOCK_MONOTONIC
+
+
+/*
+ * ftimer_now - current time in seconds
+ */
+double ftimer_now( void )
+{
+   return ( double )ftimer_ns() * 1e-9;
+}
+
+
+/*
+ * ftimer_ns - current time in nanoseconds
+ */
+long long ftimer_ns( void )
+{
+   struct timespec ts;
+
+   if ( clock_gettime( CLOCK_MONOTONIC, &ts ) != 0 )
+      unix_error( "clock_gettime error" );
+
+   return ( long long )ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
@@ -0,0 +1,21 @@
+/**
+ * @file    ftimer.h
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Wall clock timing helpers for the benchmark tools
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Source:  Adapted from CSAPP (ftimer.c)
+ *
+ * Both functions read CLOCK_MONOTONIC, which is served from the vDSO and
+ * is cheap enough to bracket individual allocator calls.
+ */
+#ifndef __2026_10_18_FTIMER_H__
+#define __2026_10_18_FTIMER_H__
+
+double    ftimer_now( void );
+long long ftimer_ns( void );
+
+#endif  // __2026_10_18_FTIMER_H__
@@ -0,0 +1,436 @@
+/**
+ * @file    heapfill.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Stress test: random requests that fill the heap to its limit
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Runs random malloc, realloc and free calls against each memlib allocator
+ * with a soft heap limit low enough that the heap keeps running into it,
+ * so that the purge hooks run in the middle of heap growth. Every block is
+ * filled with a byte pattern of its own. The test fails if an allocator
+ * returns a block that is misaligned or not inside the heap, if realloc
+ * loses the contents of a block, or if any live block is overwritten,
+ * and for mm if mm_check finds the heap inconsistent.
+ *
+ * Allocation failures at the limit are expected and only counted, but a
+ * failed request is retried at once, and the test fails if the retry
+ * succeeds: the purge hooks must have made all the room they could the
+ * first time. mem_sbrk reports each failure on stderr.
+ *
+ * After the random rounds every allocator also runs a fixed sequence at a
+ * soft limit of LIMIT_PAGES pages, which fills the heap with small blocks,
+ * frees them, and then asks for a block of most of the limit, so that the
+ * purge hook gives memory back while the heap grows for it.
+ *
+ * With -m, a heap of at least four times MM_MOVE_MIN bytes, and no mm
+ * mappings for blocks of twice MM_MOVE_MIN bytes, the mm allocators also
+ * grow a block of MM_MOVE_MIN bytes that cannot grow in place, which must
+ * move its pages rather than copy them.
+ *
+ * usage: heapfill [-h] [-a <allocator>]... [-S <KB>] [-s <bytes>] [-n <ops>]
+ *                 [-r <rounds>] [-b <bytes>] [-M <KB>] [-m] [-H <MB>]
+ */
+#include "allocators.h"
+#include "memlib.h"
+#include "mm.h"
+#include "std_wrappers.h"
+
+#include <stdint.h>         // uintptr_t
+#include <stdio.h>          // printf, fprintf
+#include <stdlib.h>         // atoi, atol, exit
+#include <string.h>         // memset, strncmp
+
+#include <unistd.h>         // getopt, optarg
+
+
+// =======================
+// Constants and Macros
+// =======================
+
+#define MAX_ALLOCATORS 16
+#define NSLOTS         1024
+#define ALIGNMENT      16
+#define CHECK_EVERY    4096          /* ops between checks of every live block */
+#define LIMIT_PAGES    18            /* soft limit of the fixed sequence, in pages */
+#define LIMIT_SMALL    253           /* small blocks of the fixed sequence */
+
+#define DEFAULT_LIMIT_KB 2048
+#define DEFAULT_MAX_SIZE 20000
+#define DEFAULT_OPS      100000
+#define DEFAULT_ROUNDS   3
+
+
+// ==========================
+// Private Global Variables
+// ==========================
+
+typedef struct
+{
+   unsigned char* p;
+   size_t         size;
+   unsigned char  fill;
+} slot_t;
+
+static slot_t   slots[ NSLOTS ];
+static unsigned seed     = 1;
+static size_t   max_size = DEFAULT_MAX_SIZE;
+static long     ops      = DEFAULT_OPS;
+static int      errors;
+
+
+// ==========================
+// Private Helper Functions
+// ==========================
+
+static unsigned next_random( void )
+{
+   seed ^= seed << 13;
+   seed ^= seed >> 17;
+   seed ^= seed << 5;
+   return seed;
+}
+
+
+/*
+ * fail - report an error of allocator name at request op
+ */
+static void fail( const char* name, long op, const char* what )
+{
+   printf( "FAIL %s: request %ld: %s\n", name, op, what );
+   ++errors;
+}
+
+
+/*
+ * intact - whether the first n bytes of the block in slot s still hold its pattern
+ */
+static int intact( const slot_t* s, size_t n )
+{
+   size_t i;
+
+   for ( i = 0; i < n; ++i )
+      if ( s->p[ i ] != s->fill )
+         return 0;
+
+   return 1;
+}
+
+
+/*
+ * take - check a block just returned for slot s and fill it
+ */
+static void take( const char* name, long op, slot_t* s, unsigned char* p, size_t size )
+{
+   if ( ( uintptr_t )p % ALIGNMENT != 0 )
+      fail( name, op, "misaligned block" );
+   if ( !mem_in_heap( p, size ) )
+      fail( name, op, "block outside the heap" );
+
+   s->p    = p;
+   s->size = size;
+   s->fill = ( unsigned char )( op | 1 );
+   memset( p, s->fill, size );
+}
+
+
+/*
+ * check_all - check every live block and, for mm, the heap
+ */
+static void check_all( const allocator_t* alloc, long op )
+{
+   int i;
+
+   for ( i = 0; i < NSLOTS; ++i )
+      if ( slots[ i ].p != NULL && !intact( &slots[ i ], slots[ i ].size ) )
+         fail( alloc->name, op, "live block overwritten" );
+
+   if ( strncmp( alloc->name, "mm", 2 ) == 0 && mm_check() < 0 )
+      fail( alloc->name, op, "mm_check found the heap inconsistent" );
+}
+
+
+/*
+ * run - one round of random requests against alloc
+ *
+ * Return: requests that failed at the heap limit
+ */
+static long run( const allocator_t* alloc )
+{
+   long nulls = 0;
+   long op;
+   int  i;
+
+   mem_reset_brk();
+   if ( alloc->init() < 0 )
+      app_error( "heapfill: allocator init failed" );
+
+   for ( op = 0; op < ops && errors == 0; ++op )
+   {
+      slot_t*        s    = &slots[ next_random() % NSLOTS ];
+      size_t         size = 1 + next_random() % max_size;
+      unsigned char* p;
+
+      if ( s->p == NULL )
+      {
+         if ( ( p = ( unsigned char* )alloc->malloc( size ) ) == NULL )
+         {
+            ++nulls;
+            if ( ( p = ( unsigned char* )alloc->malloc( size ) ) != NULL )
+            {
+               fail( alloc->name, op, "malloc failed at the limit but its retry succeeded" );
+               take( alloc->name, op, s, p, size );
+            }
+         }
+         else
+         {
+            take( alloc->name, op, s, p, size );
+         }
+      }
+      else if ( next_random() % 2 == 0 )
+      {
+         if ( !intact( s, s->size ) )
+            fail( alloc->name, op, "freed block overwritten" );
+         alloc->free( s->p );
+         s->p = NULL;
+      }
+      else if ( ( p = ( unsigned char* )alloc->realloc( s->p, size ) ) == NULL )
+      {
+         ++nulls;
+         if ( ( p = ( unsigned char* )alloc->realloc( s->p, size ) ) != NULL )
+         {
+            fail( alloc->name, op, "realloc failed at the limit but its retry succeeded" );
+            s->p = p;
+            take( alloc->name, op, s, p, size );
+         }
+      }
+      else
+      {
+         s->p = p;
+         if ( !intact( s, s->size < size ? s->size : size ) )
+            fail( alloc->name, op, "realloc lost the contents" );
+         take( alloc->name, op, s, p, size );
+      }
+
+      if ( op % CHECK_EVERY == 0 )
+         check_all( alloc, op );
+   }
+
+   check_all( alloc, op );
+
+   for ( i = 0; i < NSLOTS; ++i )
+   {
+      if ( slots[ i ].p != NULL )
+         alloc->free( slots[ i ].p );
+      slots[ i ].p = NULL;
+   }
+
+   return nulls;
+}
+
+
+/*
+ * run_move - grow a block of MM_MOVE_MIN bytes behind which another block
+ *            sits, so that mm must move it, and check that its pages moved
+ */
+static void run_move( const allocator_t* alloc )
+{
+   mem_growth_t growth;
+   slot_t       s;
+   void*        next;
+   void*        p;
+
+   mem_reset_brk();
+   if ( alloc->init() < 0 )
+      app_error( "heapfill: allocator init failed" );
+
+   if ( ( p = alloc->malloc( MM_MOVE_MIN + 1000 ) ) == NULL || ( next = alloc->malloc( 16 ) ) == NULL )
+   {
+      fail( alloc->name, 0, "no room for the block to move" );
+      return;
+   }
+   take( alloc->name, 0, &s, ( unsigned char* )p, MM_MOVE_MIN + 1000 );
+
+   if ( ( p = alloc->realloc( s.p, 2 * MM_MOVE_MIN ) ) == NULL )
+   {
+      fail( alloc->name, 1, "realloc of the block to move failed" );
+      return;
+   }
+   s.p = ( unsigned char* )p;
+   if ( !intact( &s, s.size ) )
+      fail( alloc->name, 1, "realloc lost the contents of the moved block" );
+
+   mem_growth( &growth );
+   if ( growth.moved == 0 )
+      fail( alloc->name, 1, "realloc copied the block instead of moving its pages" );
+   else
+      printf( "%-14s %zu KB moved by remapping pages\n", alloc->name, growth.moved >> 10 );
+
+   alloc->free( next );
+   alloc->free( p );
+
+   if ( mm_check() < 0 )
+      fail( alloc->name, 1, "mm_check found the heap inconsistent" );
+}
+
+
+/*
+ * run_limit - the fixed sequence at a soft limit of LIMIT_PAGES pages
+ */
+static void run_limit( const allocator_t* alloc )
+{
+   void*  small[ LIMIT_SMALL ];
+   size_t page = mem_pagesize();
+   void*  p;
+   int    i;
+
+   mem_reset_brk();
+   if ( alloc->init() < 0 )
+      app_error( "heapfill: allocator init failed" );
+
+   for ( i = 0; i < LIMIT_SMALL; ++i )
+      small[ i ] = alloc->malloc( 16 );
+   for ( i = 0; i < LIMIT_SMALL; ++i )
+      alloc->free( small[ i ] );
+
+   alloc->free( alloc->malloc( 10 * page - 64 ) );
+
+   if ( alloc->malloc( 17 * page - 64 ) == NULL && ( p = alloc->malloc( 17 * page - 64 ) ) != NULL )
+   {
+      fail( alloc->name, 0, "large malloc at the limit failed but its retry succeeded" );
+      alloc->free( p );
+   }
+
+   if ( strncmp( alloc->name, "mm", 2 ) == 0 && mm_check() < 0 )
+      fail( alloc->name, 0, "mm_check found the heap inconsistent" );
+}
+
+
+static void usage( const char* prog )
+{
+   const allocator_t* a;
+   mem_config_t       defaults;
+
+   mem_config_default( &defaults );
+
+   fprintf( stderr, "usage: %s [-h] [-a <allocator>]... [-S <KB>] [-s <bytes>] [-n <ops>]\n"
+                    "       [-r <rounds>] [-b <bytes>] [-M <KB>] [-m] [-H <MB>]\n", prog );
+   fprintf( stderr, "  -a <allocator>  allocator to test, may be repeated (default: all memlib allocators)\n" );
+   fprintf( stderr, "  -S <KB>         soft heap limit (default %d)\n", DEFAULT_LIMIT_KB );
+   fprintf( stderr, "  -s <bytes>      largest request (default %d)\n", DEFAULT_MAX_SIZE );
+   fprintf( stderr, "  -n <ops>        requests per round (default %d)\n", DEFAULT_OPS );
+   fprintf( stderr, "  -r <rounds>     rounds per allocator (default %d)\n", DEFAULT_ROUNDS );
+   fprintf( stderr, "  -b <bytes>      mm: place blocks this large at the end of the free block they split\n" );
+   fprintf( stderr, "  -M <KB>         mm: give requests this large a mapping of their own (0: off)\n" );
+   fprintf( stderr, "  -m              back the heap with a memfd, and check that mm moves pages\n" );
+   fprintf( stderr, "  -H <MB>         heap size (default %zu)\n", defaults.max_heap >> 20 );
+   fprintf( stderr, "  -h              print this message\n" );
+   fprintf( stderr, "allocators:\n" );
+   for ( a = allocators; a->name != NULL; ++a )
+      fprintf( stderr, "  %-14s %s\n", a->name, a->description );
+}
+
+
+int main( int argc, char* argv[] )
+{
+   const allocator_t* allocs[ MAX_ALLOCATORS ];
+   const allocator_t* a;
+   mem_config_t       memcfg;
+   int                nallocs = 0;
+   int                rounds  = DEFAULT_ROUNDS;
+   long               mmap_kb = -1;
+   int                c;
+   int                i;
+
+   mem_config_default( &memcfg );
+   memcfg.soft_limit = ( size_t )DEFAULT_LIMIT_KB << 10;
+
+   while ( ( c = getopt( argc, argv, "ha:S:s:n:r:b:M:mH:" ) ) != -1 )
+   {
+      switch ( c )
+      {
+         case 'a':
+            if ( nallocs == MAX_ALLOCATORS || ( allocs[ nallocs++ ] = find_allocator( optarg ) ) == NULL )
+            {
+               usage( argv[ 0 ] );
+               exit( EXIT_FAILURE );
+            }
+            break;
+         case 'S': memcfg.soft_limit = ( size_t )atol( optarg ) << 10; break;
+         case 's': max_size = ( size_t )atol( optarg ); break;
+         case 'n': ops      = atol( optarg ); break;
+         case 'r': rounds   = atoi( optarg ); break;
+         case 'b': mm_set_split( ( size_t )atol( optarg ) ); break;
+         case 'M': mmap_kb  = atol( optarg ); break;
+         case 'm': memcfg.memfd = 1; break;
+         case 'H': memcfg.max_heap = ( size_t )atol( optarg ) << 20; break;
+         case 'h':
+            usage( argv[ 0 ] );
+            exit( EXIT_SUCCESS );
+         default:
+            usage( argv[ 0 ] );
+            exit( EXIT_FAILURE );
+      }
+   }
+
+   if ( max_size < 1 || ops < 1 || rounds < 1 || memcfg.max_heap == 0 )
+      app_error( "heapfill: invalid parameters" );
+
+   if ( mmap_kb >= 0 )
+      mm_set_mmap( ( size_t )mmap_kb << 10 );
+
+   if ( nallocs == 0 )
+      for ( a = allocators; a->name != NULL && nallocs < MAX_ALLOCATORS; ++a )
+         if ( a->uses_memlib )
+            allocs[ nallocs++ ] = a;
+
+   mem_init_config( &memcfg );
+
+   printf( "%-14s %8s %10s %12s\n", "allocator", "rounds", "requests", "at limit" );
+
+   for ( i = 0; i < nallocs; ++i )
+   {
+      long nulls = 0;
+      int  r;
+
+      if ( !allocs[ i ]->uses_memlib )
+         app_error( "heapfill: the allocators must use memlib" );
+
+      seed = 1;
+      for ( r = 0; r < rounds && errors == 0; ++r )
+         nulls += run( allocs[ i ] );
+
+      printf( "%-14s %8d %10ld %12ld\n", allocs[ i ]->name, r, r * ops, nulls );
+   }
+
+   mem_deinit();
+
+   memcfg.soft_limit = LIMIT_PAGES * mem_pagesize();
+   mem_init_config( &memcfg );
+
+   for ( i = 0; i < nallocs && errors == 0; ++i )
+      run_limit( allocs[ i ] );
+
+   memcfg.soft_limit = 0;
+   if ( memcfg.memfd && memcfg.max_heap >= 4 * ( size_t )MM_MOVE_MIN && ( mmap_kb == 0 || mmap_kb > 2 * ( MM_MOVE_MIN >> 10 ) ) )
+   {
+      mem_deinit();
+      mem_init_config( &memcfg );
+
+      for ( i = 0; i < nallocs && errors == 0; ++i )
+         if ( strncmp( allocs[ i ]->name, "mm", 2 ) == 0 )
+            run_move( allocs[ i ] );
+   }
+
+   mem_deinit();
+
+   if ( errors > 0 )
+   {
+      printf( "heapfill: %d error(s)\n", errors );
+      return EXIT_FAILURE;
+   }
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,339 @@
+/**
+ * @file    json.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Source file for json.h
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include "json.h"
+#include "std_wrappers.h"
+
+#include <ctype.h>          // isspace
+#include <stdio.h>          // FILE, fread, snprintf
+#include <stdlib.h>         // free, strtod, strtol
+#include <string.h>         // memcpy, strcmp, strlen, strncmp
+
+
+// =======================
+// Types
+// =======================
+
+typedef struct
+{
+   const char* filename;
+   const char* text;
+   const char* p;          /* current position */
+} parser_t;
+
+
+// ==========================
+// Private Helper Functions
+// ==========================
+
+static json_t* parse_value( parser_t* ps );
+
+
+/*
+ * parse_error - report a syntax error with its line number and terminate
+ */
+static void parse_error( const parser_t* ps, const char* what )
+{
+   char        msg[ 256 ];
+   int         line = 1;
+   const char* q;
+
+   for ( q = ps->text; q < ps->p; ++q )
+      if ( *q == '\n' )
+         ++line;
+
+   snprintf( msg, sizeof( msg ), "%s:%d: %s", ps->filename, line, what );
+   app_error( msg );
+}
+
+
+static void skip_space( parser_t* ps )
+{
+   while ( isspace( ( unsigned char )*ps->p ) )
+      ++ps->p;
+}
+
+
+static void expect( parser_t* ps, char c )
+{
+   skip_space( ps );
+
+   if ( *ps->p != c )
+   {
+      char what[ 32 ];
+
+      snprintf( what, sizeof( what ), "expected '%c'", c );
+      parse_error( ps, what );
+   }
+
+   ++ps->p;
+}
+
+
+static json_t* new_node( json_type_t type )
+{
+   json_t* node = ( json_t* )Calloc( 1, sizeof( json_t ) );
+
+   node->type = type;
+   return node;
+}
+
+
+static char* parse_string( parser_t* ps )
+{
+   char*  out;
+   size_t len = 0;
+
+   expect( ps, '"' );
+   out = ( char* )Malloc( strlen( ps->p ) + 1 );
+
+   while ( *ps->p != '"' )
+   {
+      char c = *ps->p++;
+
+      if ( c == '\0' )
+         parse_error( ps, "unterminated string" );
+
+      if ( c == '\\' )
+      {
+         c = *ps->p++;
+         switch ( c )
+         {
+            case '\0':
+               parse_error( ps, "unterminated string" );
+               break;
+            case 'n': c = '\n'; break;
+            case 't': c = '\t'; break;
+            case 'r': c = '\r'; break;
+            case 'b': c = '\b'; break;
+            case 'f': c = '\f'; break;
+            case 'u':
+            {
+               char hex[ 5 ] = { 0 };
+               long code;
+
+               if ( strlen( ps->p ) < 4 )
+                  parse_error( ps, "truncated \\u escape" );
+               memcpy( hex, ps->p, 4 );
+               code = strtol( hex, NULL, 16 );
+               if ( code < 0 || code > 0x7F )
+                  parse_error( ps, "\\u escape outside ASCII" );
+               c      = ( char )code;
+               ps->p += 4;
+               break;
+            }
+            default:                      /* '"', '\\' and '/' */
+               break;
+         }
+      }
+
+      out[ len++ ] = c;
+   }
+
+   ++ps->p;
+   out[ len ] = '\0';
+   return out;
+}
+
+
+static json_t* parse_container( parser_t* ps, json_type_t type, char close )
+{
+   json_t*  node = new_node( type );
+   json_t** tail = &node->child;
+
+   ++ps->p;
+   skip_space( ps );
+
+   if ( *ps->p == close )
+   {
+      ++ps->p;
+      return node;
+   }
+
+   for ( ;; )
+   {
+      char*   key = NULL;
+      json_t* elem;
+
+      if ( type == JSON_OBJECT )
+      {
+         key = parse_string( ps );
+         expect( ps, ':' );
+      }
+
+      elem      = parse_value( ps );
+      elem->key = key;
+      *tail     = elem;
+      tail      = &elem->next;
+
+      skip_space( ps );
+      if ( *ps->p == ',' )
+      {
+         ++ps->p;
+         continue;
+      }
+
+      expect( ps, close );
+      return node;
+   }
+}
+
+
+static json_t* parse_value( parser_t* ps )
+{
+   json_t* node;
+   char*   end;
+
+   skip_space( ps );
+
+   switch ( *ps->p )
+   {
+      case '{':
+         return parse_container( ps, JSON_OBJECT, '}' );
+
+      case '[':
+         return parse_container( ps, JSON_ARRAY, ']' );
+
+      case '"':
+         node         = new_node( JSON_STRING );
+         node->string = parse_string( ps );
+         return node;
+
+      case 't':
+      case 'f':
+         node         = new_node( JSON_BOOL );
+         node->number = ( *ps->p == 't' );
+         if ( strncmp( ps->p, "true", 4 ) != 0 && strncmp( ps->p, "false", 5 ) != 0 )
+            parse_error( ps, "invalid literal" );
+         ps->p += node->number ? 4 : 5;
+         return node;
+
+      case 'n':
+         if ( strncmp( ps->p, "null", 4 ) != 0 )
+            parse_error( ps, "invalid literal" );
+         ps->p += 4;
+         return new_node( JSON_NULL );
+
+      default:
+         node         = new_node( JSON_NUMBER );
+         node->number = strtod( ps->p, &end );
+         if ( end == ps->p )
+            parse_error( ps, "unexpected character" );
+         ps->p = end;
+         return node;
+   }
+}
+
+
+// ==========================
+// Public Functions
+// ==========================
+
+/*
+ * json_read_file - parse a JSON document
+ *
+ * Return: the root node; terminates the program on I/O or syntax errors
+ */
+json_t* json_read_file( const char* filename )
+{
+   FILE*    fp   = Fopen( filename, "r" );
+   char*    text = NULL;
+   size_t   len  = 0;
+   size_t   cap  = 0;
+   size_t   n;
+   parser_t ps;
+   json_t*  root;
+
+   do
+   {
+      if ( len + 4096 + 1 > cap )
+      {
+         cap  = 2 * cap + 4096 + 1;
+         text = ( char* )Realloc( text, cap );
+      }
+      n    = fread( text + len, 1, 4096, fp );
+      len += n;
+   } while ( n > 0 );
+
+   Fclose( fp );
+   text[ len ] = '\0';
+
+   ps.filename = filename;
+   ps.text     = text;
+   ps.p        = text;
+
+   root = parse_value( &ps );
+   skip_space( &ps );
+   if ( *ps.p != '\0' )
+      parse_error( &ps, "trailing characters after document" );
+
+   free( text );
+   return root;
+}
+
+
+/*
+ * json_free - release a tree returned by json_read_file
+ */
+void json_free( json_t* node )
+{
+   while ( node != NULL )
+   {
+      json_t* next = node->next;
+
+      json_free( node->child );
+      free( node->key );
+      free( node->string );
+      free( node );
+      node = next;
+   }
+}
+
+
+/*
+ * json_get - member of an object by name, or NULL
+ */
+json_t* json_get( const json_t* object, const char* key )
+{
+   json_t* m;
+
+   if ( object == NULL || object->type != JSON_OBJECT )
+      return NULL;
+
+   for ( m = object->child; m != NULL; m = m->next )
+      if ( strcmp( m->key, key ) == 0 )
+         return m;
+
+   return NULL;
+}
+
+
+/*
+ * json_number - numeric or boolean member of an object, or dflt if absent
+ */
+double json_number( const json_t* object, const char* key, double dflt )
+{
+   const json_t* m = json_get( object, key );
+
+   if ( m == NULL || ( m->type != JSON_NUMBER && m->type != JSON_BOOL ) )
+      return dflt;
+
+   return m->number;
+}
+
+
+/*
+ * json_string - string member of an object, or NULL if absent
+ */
+const char* json_string( const json_t* object, const char* key )
+{
+   const json_t* m = json_get( object, key );
+
+   return ( m != NULL && m->type == JSON_STRING ) ? m->string : NULL;
+}
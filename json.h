@@ -0,0 +1,46 @@
+/**
+ * @file    json.h
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Minimal JSON reader for the benchmark result files
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Parses a complete document into a tree of json_t nodes. Only what the
+ * result files need is supported: no unicode escapes beyond \uXXXX for
+ * ASCII, and numbers are stored as doubles.
+ */
+#ifndef __2026_10_18_JSON_H__
+#define __2026_10_18_JSON_H__
+
+typedef enum
+{
+   JSON_NULL,
+   JSON_BOOL,
+   JSON_NUMBER,
+   JSON_STRING,
+   JSON_ARRAY,
+   JSON_OBJECT
+} json_type_t;
+
+typedef struct json json_t;
+
+struct json
+{
+   json_type_t type;
+   char*       key;        /* member name when inside an object          */
+   double      number;     /* JSON_NUMBER value, or 0/1 for JSON_BOOL    */
+   char*       string;     /* JSON_STRING value                          */
+   json_t*     child;      /* first element or member                    */
+   json_t*     next;       /* next sibling                               */
+};
+
+json_t*     json_read_file( const char* filename );
+void        json_free( json_t* node );
+
+json_t*     json_get( const json_t* object, const char* key );
+double      json_number( const json_t* object, const char* key, double dflt );
+const char* json_string( const json_t* object, const char* key );
+
+#endif  // __2026_10_18_JSON_H__
@@ -0,0 +1,193 @@
+/**
+ * @file    larson.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Larson server simulation benchmark
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Source:  Larson and Krishnan, "Memory Allocation for Long-Running Server
+ *          Applications", ISMM 1998
+ *
+ * Every thread owns an array of live blocks. It repeatedly frees a random
+ * block and replaces it with a new one of random size. After a number of
+ * rounds the thread starts a successor that inherits the array and exits,
+ * so blocks allocated by one thread are freed by another, as in a server
+ * whose connections migrate between worker threads. The benchmark runs for
+ * a fixed time and counts replacements.
+ *
+ * usage: larson [-h] [-a <allocator>] [-t <max threads>] [-s <secs>]
+ *               [-n <blocks>] [-m <min size>] [-M <max size>] [-r <rounds>]
+ */
+#include "bench.h"
+#include "ftimer.h"
+#include "std_wrappers.h"
+
+#include <pthread.h>        // pthread_t, pthread_mutex_t, pthread_cond_t
+#include <stdatomic.h>      // atomic_int, atomic_load, atomic_store
+#include <stdlib.h>         // atof, atoi, exit, free
+
+#include <unistd.h>         // optarg, usleep
+
+
+// =======================
+// Types
+// =======================
+
+typedef struct
+{
+   char**   blocks;      /* live blocks owned by the thread chain */
+   unsigned seed;
+   long     ops;         /* replacements done by the chain        */
+} chain_t;
+
+
+// ==========================
+// Private Global Variables
+// ==========================
+
+static double nsecs    = 1.0;
+static int    nblocks  = 1000;
+static int    min_size = 10;
+static int    max_size = 400;
+static int    rounds   = 10000;
+
+static atomic_int      stop;
+static int             finished;
+static pthread_mutex_t finished_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  finished_cond = PTHREAD_COND_INITIALIZER;
+
+
+// ==========================
+// Private Helper Functions
+// ==========================
+
+static size_t random_size( unsigned* seed )
+{
+   return min_size + bench_rand( seed ) % ( unsigned )( max_size - min_size + 1 );
+}
+
+
+/*
+ * worker - one generation of a thread chain
+ */
+static void* worker( void* arg )
+{
+   chain_t*  chain = ( chain_t* )arg;
+   pthread_t successor;
+   int       i;
+
+   for ( i = 0; i < rounds && !atomic_load( &stop ); ++i )
+   {
+      int    victim = bench_rand( &chain->seed ) % nblocks;
+      size_t size   = random_size( &chain->seed );
+
+      bench_free( chain->blocks[ victim ] );
+      chain->blocks[ victim ]      = bench_malloc( size );
+      chain->blocks[ victim ][ 0 ] = ( char )i;
+      ++chain->ops;
+   }
+
+   if ( !atomic_load( &stop ) )
+   {
+      Pthread_create( &successor, NULL, worker, chain );
+      Pthread_detach( successor );
+      return NULL;
+   }
+
+   pthread_mutex_lock( &finished_lock );
+   ++finished;
+   pthread_cond_signal( &finished_cond );
+   pthread_mutex_unlock( &finished_lock );
+
+   return NULL;
+}
+
+
+static bench_result_t run( int nthreads )
+{
+   chain_t*       chains = ( chain_t* )Calloc( nthreads, sizeof( chain_t ) );
+   bench_result_t res    = { 0.0, 0.0 };
+   pthread_t      tid;
+   double         start;
+   int            t;
+   int            i;
+
+   for ( t = 0; t < nthreads; ++t )
+   {
+      chains[ t ].seed   = 2463534242u + t;
+      chains[ t ].blocks = ( char** )Calloc( nblocks, sizeof( char* ) );
+      for ( i = 0; i < nblocks; ++i )
+         chains[ t ].blocks[ i ] = bench_malloc( random_size( &chains[ t ].seed ) );
+   }
+
+   atomic_store( &stop, 0 );
+   finished = 0;
+   start    = ftimer_now();
+
+   for ( t = 0; t < nthreads; ++t )
+   {
+      Pthread_create( &tid, NULL, worker, &chains[ t ] );
+      Pthread_detach( tid );
+   }
+
+   usleep( ( useconds_t )( nsecs * 1e6 ) );
+   atomic_store( &stop, 1 );
+
+   pthread_mutex_lock( &finished_lock );
+   while ( finished < nthreads )
+      pthread_cond_wait( &finished_cond, &finished_lock );
+   pthread_mutex_unlock( &finished_lock );
+
+   res.secs = ftimer_now() - start;
+
+   for ( t = 0; t < nthreads; ++t )
+   {
+      res.ops += chains[ t ].ops;
+      for ( i = 0; i < nblocks; ++i )
+         bench_free( chains[ t ].blocks[ i ] );
+      free( chains[ t ].blocks );
+   }
+
+   free( chains );
+   return res;
+}
+
+
+int main( int argc, char* argv[] )
+{
+   const char* options = "[-s <secs>] [-n <blocks>] [-m <min size>] [-M <max size>] [-r <rounds>]";
+   const char* help    = "  -s <secs>         run time per thread count (default 1)\n"
+                         "  -n <blocks>       live blocks per thread (default 1000)\n"
+                         "  -m <min size>     smallest block size (default 10)\n"
+                         "  -M <max size>     largest block size (default 400)\n"
+                         "  -r <rounds>       replacements before a thread hands over (default 10000)\n";
+   int         c;
+
+   while ( ( c = bench_getopt( argc, argv, "hs:n:m:M:r:" ) ) != -1 )
+   {
+      switch ( c )
+      {
+         case 's': nsecs    = atof( optarg ); break;
+         case 'n': nblocks  = atoi( optarg ); break;
+         case 'm': min_size = atoi( optarg ); break;
+         case 'M': max_size = atoi( optarg ); break;
+         case 'r': rounds   = atoi( optarg ); break;
+         case 'h':
+            bench_usage( argv[ 0 ], options, help );
+            exit( EXIT_SUCCESS );
+         default:
+            bench_usage( argv[ 0 ], options, help );
+            exit( EXIT_FAILURE );
+      }
+   }
+
+   if ( nblocks < 1 || min_size < 1 || max_size < min_size || rounds < 1 )
+      app_error( "larson: invalid parameters" );
+
+   bench_setup();
+   bench_scaling( "larson", run );
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,443 @@
+/**
+ * @file    locality.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Locality-of-reference benchmark for allocated blocks
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Allocator placement decides how close together the nodes of a data
+ * structure end up, and so how fast code that walks them runs. This
+ * benchmark builds a linked list, a binary search tree and a chained hash
+ * table through the allocator, interleaving their allocations as a real
+ * program would, and mixes in short-lived "noise" blocks of random size
+ * that are freed once the structures are built, leaving holes behind.
+ *
+ * It then times repeated traversals of each structure and, where the
+ * kernel allows perf_event_open, counts L1 data cache and last level cache
+ * misses. The mean distance in bytes between consecutive list nodes is
+ * reported as well; it does not depend on performance counters.
+ *
+ * usage: locality [-h] [-a <allocator>] [-n <nodes>] [-p <passes>]
+ *                 [-g <noise>] [-s <seed>]
+ */
+#define _GNU_SOURCE                 // syscall
+
+#include "allocators.h"
+#include "ftimer.h"
+#include "memlib.h"
+#include "std_wrappers.h"
+
+#include <linux/perf_event.h>   // perf_event_attr, PERF_*
+#include <stdint.h>             // uint64_t, uintptr_t
+#include <stdio.h>              // printf, fprintf
+#include <stdlib.h>             // atoi, exit, free, llabs
+#include <string.h>             // memset
+
+#include <sys/ioctl.h>          // ioctl
+#include <sys/syscall.h>        // SYS_perf_event_open
+#include <unistd.h>             // getopt, read, syscall
+
+
+// =======================
+// Constants and Macros
+// =======================
+
+#define NCOUNTERS 2            /* L1D read misses, last level cache misses */
+
+
+// =======================
+// Types
+// =======================
+
+typedef struct list_node list_node_t;
+typedef struct tree_node tree_node_t;
+typedef struct hash_node hash_node_t;
+
+struct list_node
+{
+   list_node_t* next;
+   long         value;
+};
+
+struct tree_node
+{
+   tree_node_t* left;
+   tree_node_t* right;
+   long         key;
+};
+
+struct hash_node
+{
+   hash_node_t* next;
+   long         key;
+};
+
+typedef struct
+{
+   double   secs;
+   uint64_t misses[ NCOUNTERS ];
+   int      counted;             /* performance counters were available */
+} measurement_t;
+
+
+// ==========================
+// Private Global Variables
+// ==========================
+
+static const allocator_t* alloc   = NULL;
+static int                nnodes  = 10000;
+static int                npasses = 20;
+static int                noise   = 1;         /* noise blocks per node */
+static unsigned           seed    = 12345;
+
+static int                counters[ NCOUNTERS ] = { -1, -1 };
+static volatile long      sink;                /* keeps traversals alive */
+
+
+// ==========================
+// Performance Counters
+// ==========================
+
+static int open_counter( uint32_t type, uint64_t config )
+{
+   struct perf_event_attr attr;
+
+   memset( &attr, 0, sizeof( attr ) );
+   attr.size           = sizeof( attr );
+   attr.type           = type;
+   attr.config         = config;
+   attr.disabled       = 1;
+   attr.exclude_kernel = 1;
+   attr.exclude_hv     = 1;
+
+   return ( int )syscall( SYS_perf_event_open, &attr, 0, -1, -1, 0 );
+}
+
+
+static void open_counters( void )
+{
+   counters[ 0 ] = open_counter( PERF_TYPE_HW_CACHE,
+                                 PERF_COUNT_HW_CACHE_L1D
+                                 | ( PERF_COUNT_HW_CACHE_OP_READ << 8 )
+                                 | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 ) );
+   counters[ 1 ] = open_counter( PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES );
+}
+
+
+static void start_counters( void )
+{
+   int i;
+
+   for ( i = 0; i < NCOUNTERS; ++i )
+   {
+      if ( counters[ i ] < 0 )
+         continue;
+      ioctl( counters[ i ], PERF_EVENT_IOC_RESET, 0 );
+      ioctl( counters[ i ], PERF_EVENT_IOC_ENABLE, 0 );
+   }
+}
+
+
+static void stop_counters( measurement_t* m )
+{
+   int i;
+
+   m->counted = 0;
+
+   for ( i = 0; i < NCOUNTERS; ++i )
+   {
+      m->misses[ i ] = 0;
+      if ( counters[ i ] < 0 )
+         continue;
+      ioctl( counters[ i ], PERF_EVENT_IOC_DISABLE, 0 );
+      if ( read( counters[ i ], &m->misses[ i ], sizeof( uint64_t ) ) == sizeof( uint64_t ) )
+         m->counted = 1;
+   }
+}
+
+
+// ==========================
+// Allocation Helpers
+// ==========================
+
+static unsigned next_rand( void )
+{
+   seed ^= seed << 13;
+   seed ^= seed >> 17;
+   seed ^= seed << 5;
+
+   return seed;
+}
+
+
+static void* allocate( size_t size )
+{
+   void* p = alloc->malloc( size );
+
+   if ( p == NULL )
+      app_error( "locality: allocator out of memory" );
+
+   return p;
+}
+
+
+// ==========================
+// Data Structures
+// ==========================
+
+static tree_node_t* tree_insert( tree_node_t* root, tree_node_t* node )
+{
+   tree_node_t** link = &root;
+
+   while ( *link != NULL )
+      link = ( node->key < ( *link )->key ) ? &( *link )->left : &( *link )->right;
+
+   *link = node;
+   return root;
+}
+
+
+static long tree_sum( const tree_node_t* node )
+{
+   long sum = 0;
+
+   while ( node != NULL )          /* recurse left, loop right */
+   {
+      sum += tree_sum( node->left ) + node->key;
+      node = node->right;
+   }
+
+   return sum;
+}
+
+
+static void tree_free( tree_node_t* node )
+{
+   while ( node != NULL )
+   {
+      tree_node_t* right = node->right;
+
+      tree_free( node->left );
+      alloc->free( node );
+      node = right;
+   }
+}
+
+
+// ==========================
+// Benchmark
+// ==========================
+
+static void report( const char* what, const measurement_t* m, long touched )
+{
+   printf( "%-12s %12.2f", what, 1e9 * m->secs / touched );
+
+   if ( m->counted )
+      printf( " %14.3f %14.3f\n", ( double )m->misses[ 0 ] / touched, ( double )m->misses[ 1 ] / touched );
+   else
+      printf( " %14s %14s\n", "n/a", "n/a" );
+}
+
+
+static void run( void )
+{
+   int           nbuckets = nnodes;
+   list_node_t*  head     = NULL;
+   list_node_t** tail     = &head;
+   tree_node_t*  root     = NULL;
+   hash_node_t** buckets  = ( hash_node_t** )allocate( nbuckets * sizeof( hash_node_t* ) );
+   void**        noisy    = ( void** )Calloc( ( size_t )nnodes * noise + 1, sizeof( void* ) );
+   long*         keys     = ( long* )Calloc( nnodes, sizeof( long ) );
+   long          nnoisy   = 0;
+   double        distance = 0.0;
+   measurement_t m;
+   double        start;
+   int           pass;
+   int           i;
+   int           j;
+
+   memset( buckets, 0, nbuckets * sizeof( hash_node_t* ) );
+
+   /* Build all three structures at once, with noise in between */
+   for ( i = 0; i < nnodes; ++i )
+   {
+      list_node_t* ln = ( list_node_t* )allocate( sizeof( list_node_t ) );
+      tree_node_t* tn = ( tree_node_t* )allocate( sizeof( tree_node_t ) );
+      hash_node_t* hn = ( hash_node_t* )allocate( sizeof( hash_node_t ) );
+      long         key = ( long )next_rand();
+
+      keys[ i ] = key;
+
+      ln->next  = NULL;
+      ln->value = i;
+      *tail     = ln;
+      tail      = &ln->next;
+
+      tn->left  = tn->right = NULL;
+      tn->key   = key;
+      root      = tree_insert( root, tn );
+
+      hn->key   = key;
+      hn->next  = buckets[ key % nbuckets ];
+      buckets[ key % nbuckets ] = hn;
+
+      for ( j = 0; j < noise; ++j )
+         noisy[ nnoisy++ ] = allocate( 16 + next_rand() % 241 );
+   }
+
+   for ( i = 0; i < nnoisy; ++i )
+      alloc->free( noisy[ i ] );
+
+   {
+      const list_node_t* p;
+
+      for ( p = head; p != NULL && p->next != NULL; p = p->next )
+         distance += llabs( ( long long )( ( uintptr_t )p->next - ( uintptr_t )p ) );
+      distance /= ( nnodes > 1 ? nnodes - 1 : 1 );
+   }
+
+   printf( "%d nodes per structure, %d noise block(s) per node, %d passes\n", nnodes, noise, npasses );
+   printf( "mean distance between consecutive list nodes: %.1f bytes\n\n", distance );
+   printf( "%-12s %12s %14s %14s\n", "structure", "ns/node", "L1D miss/node", "LLC miss/node" );
+
+   /* Linked list: follow next pointers */
+   start_counters();
+   start = ftimer_now();
+   for ( pass = 0; pass < npasses; ++pass )
+   {
+      const list_node_t* p;
+      long               sum = 0;
+
+      for ( p = head; p != NULL; p = p->next )
+         sum += p->value;
+      sink = sum;
+   }
+   m.secs = ftimer_now() - start;
+   stop_counters( &m );
+   report( "list", &m, ( long )npasses * nnodes );
+
+   /* Tree: in-order traversal */
+   start_counters();
+   start = ftimer_now();
+   for ( pass = 0; pass < npasses; ++pass )
+      sink = tree_sum( root );
+   m.secs = ftimer_now() - start;
+   stop_counters( &m );
+   report( "tree", &m, ( long )npasses * nnodes );
+
+   /* Hash table: look every key up in insertion order */
+   start_counters();
+   start = ftimer_now();
+   for ( pass = 0; pass < npasses; ++pass )
+   {
+      long found = 0;
+
+      for ( i = 0; i < nnodes; ++i )
+      {
+         const hash_node_t* h;
+
+         for ( h = buckets[ keys[ i ] % nbuckets ]; h != NULL; h = h->next )
+            if ( h->key == keys[ i ] )
+            {
+               ++found;
+               break;
+            }
+      }
+      sink = found;
+   }
+   m.secs = ftimer_now() - start;
+   stop_counters( &m );
+   report( "hash table", &m, ( long )npasses * nnodes );
+
+   /* Tear down */
+   while ( head != NULL )
+   {
+      list_node_t* next = head->next;
+
+      alloc->free( head );
+      head = next;
+   }
+   tree_free( root );
+   for ( i = 0; i < nbuckets; ++i )
+   {
+      hash_node_t* h = buckets[ i ];
+
+      while ( h != NULL )
+      {
+         hash_node_t* next = h->next;
+
+         alloc->free( h );
+         h = next;
+      }
+   }
+   alloc->free( buckets );
+
+   free( keys );
+   free( noisy );
+}
+
+
+static void usage( const char* prog )
+{
+   const allocator_t* a;
+
+   fprintf( stderr, "usage: %s [-h] [-a <allocator>] [-n <nodes>] [-p <passes>] [-g <noise>] [-s <seed>]\n", prog );
+   fprintf( stderr, "  -a <allocator>  allocator to benchmark (default mm)\n" );
+   fprintf( stderr, "  -n <nodes>      nodes per data structure (default 10000)\n" );
+   fprintf( stderr, "  -p <passes>     traversals of each structure (default 20)\n" );
+   fprintf( stderr, "  -g <noise>      short-lived blocks allocated per node (default 1)\n" );
+   fprintf( stderr, "  -s <seed>       random seed for keys and noise sizes\n" );
+   fprintf( stderr, "  -h              print this message\n" );
+   fprintf( stderr, "allocators:\n" );
+   for ( a = allocators; a->name != NULL; ++a )
+      fprintf( stderr, "  %-14s %s\n", a->name, a->description );
+}
+
+
+int main( int argc, char* argv[] )
+{
+   int c;
+
+   alloc = find_allocator( "mm" );
+
+   while ( ( c = getopt( argc, argv, "ha:n:p:g:s:" ) ) != -1 )
+   {
+      switch ( c )
+      {
+         case 'a':
+            if ( ( alloc = find_allocator( optarg ) ) == NULL )
+            {
+               usage( argv[ 0 ] );
+               exit( EXIT_FAILURE );
+            }
+            break;
+         case 'n': nnodes  = atoi( optarg ); break;
+         case 'p': npasses = atoi( optarg ); break;
+         case 'g': noise   = atoi( optarg ); break;
+         case 's': seed    = ( unsigned )atoi( optarg ); break;
+         case 'h':
+            usage( argv[ 0 ] );
+            exit( EXIT_SUCCESS );
+         default:
+            usage( argv[ 0 ] );
+            exit( EXIT_FAILURE );
+      }
+   }
+
+   if ( nnodes < 1 || npasses < 1 || noise < 0 || seed == 0 )
+      app_error( "locality: invalid parameters" );
+
+   mem_init();
+   if ( alloc->init() < 0 )
+      app_error( "locality: allocator init failed" );
+
+   open_counters();
+
+   printf( "Allocator %s: %s\n", alloc->name, alloc->description );
+   run();
+
+   mem_deinit();
+   return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,291 @@
+/**
+ * @file    mdcompare.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Compare two mdriver JSON result files and detect regressions
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Traces are matched by name. For each pair the tool compares:
+ *
+ *    - throughput (higher is better)
+ *    - mean latency of all requests and of each request type (lower is better)
+ *    - space utilization (higher is better), peak heap size and peak resident
+ *      bytes (lower is better)
+ *
+ * Timing metrics are tested with Welch's t-test on the per-repetition
+ * samples; a change counts as a regression only if it is both worse than
+ * the threshold and significant at the 95% level. Utilization and memory
+ * sizes are deterministic, so for them the threshold alone decides. A
+ * trace that is missing from the candidate, or was valid in the baseline
+ * and is invalid in the candidate, is always a regression.
+ *
+ * Exit status: 0 if there are no regressions, 1 otherwise.
+ *
+ * usage: mdcompare [-h] [-t <percent>] <baseline.json> <candidate.json>
+ */
+#include "json.h"
+#include "stats.h"
+#include "std_wrappers.h"
+
+#include <stdio.h>          // printf, fprintf, stderr
+#include <stdlib.h>         // atof, exit, free
+#include <string.h>         // strcmp
+
+#include <unistd.h>         // getopt, optarg, optind
+
+
+// =======================
+// Constants and Macros
+// =======================
+
+#define DEFAULT_THRESHOLD 3.0   /* percent change that counts as a regression */
+#define MAX_SAMPLES       1024
+#define NAME_WIDTH        24
+
+
+// ==========================
+// Private Global Variables
+// ==========================
+
+static double threshold   = DEFAULT_THRESHOLD;
+static int    regressions = 0;
+
+
+// ==========================
+// Private Helper Functions
+// ==========================
+
+/*
+ * find_trace - trace entry of a result file by name, or NULL
+ */
+static const json_t* find_trace( const json_t* root, const char* name )
+{
+   const json_t* traces = json_get( root, "traces" );
+   const json_t* t;
+
+   if ( traces == NULL )
+      return NULL;
+
+   for ( t = traces->child; t != NULL; t = t->next )
+   {
+      const char* tname = json_string( t, "name" );
+
+      if ( tname != NULL && strcmp( tname, name ) == 0 )
+         return t;
+   }
+
+   return NULL;
+}
+
+
+/*
+ * get_samples - copy the "samples" array of a summary object
+ *
+ * Return: the number of samples copied
+ */
+static int get_samples( const json_t* summary, double* out )
+{
+   const json_t* arr = json_get( summary, "samples" );
+   const json_t* e;
+   int           n = 0;
+
+   if ( arr == NULL )
+      return 0;
+
+   for ( e = arr->child; e != NULL && n < MAX_SAMPLES; e = e->next )
+      if ( e->type == JSON_NUMBER )
+         out[ n++ ] = e->number;
+
+   return n;
+}
+
+
+/*
+ * verdict - print one comparison line and count regressions
+ *
+ * worse is the relative change in the bad direction, in percent.
+ */
+static void verdict( const char* trace, const char* metric, double base, double cand,
+                     double worse, int tested, int significant )
+{
+   const char* what = "~";
+
+   if ( worse > threshold && significant )
+   {
+      what = "REGRESSION";
+      ++regressions;
+   }
+   else if ( -worse > threshold && significant )
+   {
+      what = "improved";
+   }
+   else if ( tested && !significant && ( worse > threshold || -worse > threshold ) )
+   {
+      what = "~ (not significant)";
+   }
+
+   printf( "%-*.*s %-16s %14.6g %14.6g %+8.2f%%  %s\n", NAME_WIDTH, NAME_WIDTH, trace, metric,
+           base, cand, base != 0.0 ? 100.0 * ( cand - base ) / base : 0.0, what );
+}
+
+
+/*
+ * compare_timing - compare a timing summary of both runs with a t-test
+ */
+static void compare_timing( const char* trace, const char* metric, const json_t* base,
+                            const json_t* cand, int higher_is_better )
+{
+   static double a[ MAX_SAMPLES ];
+   static double b[ MAX_SAMPLES ];
+   double        bm = json_number( base, "median", 0.0 );
+   double        cm = json_number( cand, "median", 0.0 );
+   int           na;
+   int           nb;
+   double        t;
+   int           significant;
+   double        worse;
+
+   if ( base == NULL || cand == NULL || bm == 0.0 )
+      return;
+
+   na          = get_samples( base, a );
+   nb          = get_samples( cand, b );
+   significant = stats_welch( a, na, b, nb, &t );
+   worse       = 100.0 * ( cm - bm ) / bm;
+
+   if ( higher_is_better )
+      worse = -worse;
+
+   verdict( trace, metric, bm, cm, worse, 1, significant );
+}
+
+
+/*
+ * compare_exact - compare a deterministic metric against the threshold alone
+ */
+static void compare_exact( const char* trace, const char* metric, const json_t* base,
+                           const json_t* cand, const char* key, int higher_is_better )
+{
+   double bv = json_number( base, key, -1.0 );
+   double cv = json_number( cand, key, -1.0 );
+   double worse;
+
+   if ( bv <= 0.0 || cv < 0.0 )
+      return;
+
+   worse = 100.0 * ( cv - bv ) / bv;
+   if ( higher_is_better )
+      worse = -worse;
+
+   verdict( trace, metric, bv, cv, worse, 0, 1 );
+}
+
+
+static void compare_trace( const char* name, const json_t* base, const json_t* cand )
+{
+   static const char* const kinds[] = { "all", "alloc", "free", "realloc" };
+   const json_t*            bl      = json_get( base, "latency" );
+   const json_t*            cl      = json_get( cand, "latency" );
+   unsigned                 k;
+
+   if ( !json_number( base, "valid", 0.0 ) )
+      return;
+
+   if ( !json_number( cand, "valid", 0.0 ) )
+   {
+      printf( "%-*.*s %-16s %14s %14s %9s  REGRESSION\n", NAME_WIDTH, NAME_WIDTH, name, "valid", "yes", "no", "" );
+      ++regressions;
+      return;
+   }
+
+   compare_timing( name, "throughput", json_get( base, "throughput" ), json_get( cand, "throughput" ), 1 );
+
+   for ( k = 0; k < sizeof( kinds ) / sizeof( kinds[ 0 ] ); ++k )
+   {
+      const json_t* bk = json_get( bl, kinds[ k ] );
+      const json_t* ck = json_get( cl, kinds[ k ] );
+      char          metric[ 32 ];
+
+      if ( json_number( bk, "count", 0.0 ) == 0.0 )
+         continue;
+
+      snprintf( metric, sizeof( metric ), "%s ns/op", kinds[ k ] );
+      compare_timing( name, metric, json_get( bk, "mean_ns" ), json_get( ck, "mean_ns" ), 0 );
+   }
+
+   compare_exact( name, "util", base, cand, "util", 1 );
+   compare_exact( name, "peak_heapsize", base, cand, "peak_heapsize", 0 );
+   compare_exact( name, "resident_peak", base, cand, "resident_peak", 0 );
+}
+
+
+static void usage( const char* prog )
+{
+   fprintf( stderr, "usage: %s [-h] [-t <percent>] <baseline.json> <candidate.json>\n", prog );
+   fprintf( stderr, "  -t <percent>  smallest change in the bad direction that is a regression (default %.1f)\n", DEFAULT_THRESHOLD );
+   fprintf( stderr, "  -h            print this message\n" );
+}
+
+
+int main( int argc, char* argv[] )
+{
+   json_t*       base;
+   json_t*       cand;
+   const json_t* t;
+   int           c;
+
+   while ( ( c = getopt( argc, argv, "ht:" ) ) != -1 )
+   {
+      switch ( c )
+      {
+         case 't':
+            threshold = atof( optarg );
+            break;
+         case 'h':
+            usage( argv[ 0 ] );
+            exit( EXIT_SUCCESS );
+         default:
+            usage( argv[ 0 ] );
+            exit( EXIT_FAILURE );
+      }
+   }
+
+   if ( argc - optind != 2 )
+   {
+      usage( argv[ 0 ] );
+      exit( EXIT_FAILURE );
+   }
+
+   base = json_read_file( argv[ optind ] );
+   cand = json_read_file( argv[ optind + 1 ] );
+
+   printf( "baseline:  %s (%s)\ncandidate: %s (%s)\nthreshold: %.2f%%, significance: 95%% (Welch's t-test)\n\n",
+           argv[ optind ], json_string( base, "allocator" ), argv[ optind + 1 ], json_string( cand, "allocator" ),
+           threshold );
+   printf( "%-*s %-16s %14s %14s %9s  %s\n", NAME_WIDTH, "trace", "metric", "baseline", "candidate", "change", "verdict" );
+
+   for ( t = json_get( base, "traces" ) ? json_get( base, "traces" )->child : NULL; t != NULL; t = t->next )
+   {
+      const char*   name  = json_string( t, "name" );
+      const json_t* other = name ? find_trace( cand, name ) : NULL;
+
+      if ( other == NULL )
+      {
+         printf( "%-*.*s %-16s %14s %14s %9s  REGRESSION\n", NAME_WIDTH, NAME_WIDTH, name ? name : "?",
+                 "present", "yes", "no", "" );
+         ++regressions;
+         continue;
+      }
+
+      compare_trace( name, t, other );
+   }
+
+   printf( "\n%d regression(s)\n", regressions );
+
+   json_free( cand );
+   json_free( base );
+
+   return regressions ? EXIT_FAILURE : EXIT_SUCCESS;
+}
\ No newline at end of file
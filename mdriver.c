@@ -0,0 +1,1121 @@
+/**
+ * @file    mdriver.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Benchmark driver: replays trace files against an allocator
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Source:  Adapted from CSAPP (mdriver.c)
+ *
+ * Every trace is first replayed once with correctness checks, which also
+ * measures space utilization: the peak live payload divided by the peak
+ * heap footprint that memlib reports, so a heap trimmed before the end of
+ * the trace gets no credit for it. The trace is then replayed for a number
+ * of unmeasured warm-up runs followed by measured repetitions. Each
+ * repetition consists of a throughput run, timing the whole replay, and a
+ * latency run, timing each request on its own so that clock reads do not
+ * distort the throughput.
+ *
+ * For both metrics the driver reports the median over the repetitions,
+ * the standard deviation and the half-width of the 95% confidence interval
+ * of the mean, both relative to the mean. Traces whose interval is wider
+ * than a threshold are flagged as too noisy to compare.
+ *
+ * The checked run also measures memory: the resident bytes of the memlib
+ * region, sampled with mincore, and the minor and major page faults taken,
+ * from getrusage. Each trace starts on a freshly mapped region, so these
+ * are the trace's own and credit allocators that give pages back.
+ *
+ * With -j the results, including latency percentiles per request type and
+ * the raw per-repetition samples, are also written as JSON for mdcompare.
+ *
+ * With -T the checked run also records a time series of the heap size,
+ * the live payload bytes and the resident bytes of the memlib region every
+ * few requests, written as CSV, so footprint curves can be compared.
+ *
+ * With -A the driver does not benchmark; it runs the aging simulation of
+ * aging.c on every trace instead, to check that the footprint of an
+ * allocator stays bounded under indefinite churn.
+ *
+ * -F and -G move the page faults of heap growth off the request path, by
+ * pre-faulting in mem_sbrk or at init, or in a background thread that
+ * keeps pages above the brk faulted in. -R makes trims and resets of the
+ * heap give its pages back to the OS, at the cost of faulting them in again.
+ * -B and -L place the heap at a fixed address and alignment, so that every
+ * run sees the same layout. -C makes mm hint the pages of free blocks that
+ * stay free for a number of requests as cold, so that reclaim takes them
+ * before the pages in use; the bytes hinted are reported. -S sets a soft
+ * heap limit, at which memlib purges the allocator before failing; how
+ * often each trace reached it is reported.
+ *
+ * -f and -g choose the placement policy of mm, first, next or best fit,
+ * and how close a best fit has to be to end the search. -b makes mm place
+ * blocks of at least that size at the end of the free block they split.
+ * -N sets the size from which realloc copies its blocks with non-temporal
+ * stores that bypass the cache. -M sets the size from which mm gives a
+ * request a mapping of its own, which realloc resizes with mremap. -m
+ * backs the heap with a memfd, so that mm realloc can move the pages of
+ * heap blocks of MM_MOVE_MIN bytes or more instead of copying them; -H
+ * makes the heap large enough to hold such a block twice.
+ *
+ * usage: mdriver [-hv] [-a <allocator>] [-w <warmups>] [-n <reps>]
+ *                [-c <cpu>] [-x <percent>] [-j <file>] [-T <file> [-i <requests>]]
+ *                [-A <epochs> [-P <percent>] [-D <requests>]]
+ *                [-F <sbrk|all>] [-G <KB>] [-R] [-B <addr|fixed>] [-L <KB>]
+ *                [-C <requests>] [-S <KB>] [-f <first|next|best> [-g <percent>]]
+ *                [-b <bytes>] [-N <KB>] [-M <KB>] [-m] [-H <MB>] <tracefile>...
+ */
+#define _GNU_SOURCE                 // sched_setaffinity, CPU_SET
+
+#include "aging.h"
+#include "allocators.h"
+#include "ftimer.h"
+#include "memlib.h"
+#include "mm.h"
+#include "stats.h"
+#include "std_wrappers.h"
+#include "trace.h"
+
+#include <sched.h>          // cpu_set_t, sched_setaffinity
+#include <stdint.h>         // uintptr_t
+#include <stdio.h>          // printf, fprintf, snprintf
+#include <stdlib.h>         // atoi, atof, atol, exit, free, strtoull
+#include <string.h>         // memset, strcmp, strlen, strrchr
+
+#include <sys/resource.h>   // getrusage, RUSAGE_SELF
+#include <unistd.h>         // getopt, optarg, optind
+
+
+// =======================
+// Constants and Macros
+// =======================
+
+#define ALIGNMENT        16     /* required payload alignment              */
+#define DEFAULT_WARMUPS  1
+#define DEFAULT_REPS     5
+#define DEFAULT_MAX_CI   1.0    /* flag traces whose 95% CI exceeds this % */
+#define NAME_WIDTH       24
+#define NKINDS           4      /* latency breakdown: all requests, then per type */
+#define NPCTS            4      /* latency percentiles reported per kind          */
+#define SERIES_POINTS    500    /* default number of time series samples per trace */
+
+
+// =======================
+// Types
+// =======================
+
+typedef struct
+{
+   long            count;            /* requests of this kind per run       */
+   stats_summary_t mean;             /* mean ns per request                 */
+   double          pct[ NPCTS ];     /* median over repetitions, in ns      */
+   double*         samples;          /* mean ns per request of each rep     */
+} op_latency_t;
+
+typedef struct
+{
+   const char*     name;             /* trace file name without directories   */
+   int             num_ops;
+   int             valid;
+   double          util;             /* peak payload / heap size (memlib only) */
+   size_t          heapsize;         /* peak heap size (memlib only)           */
+   size_t          resident_peak;    /* peak resident bytes (memlib only)      */
+   size_t          resident_end;     /* resident bytes at the end (memlib only) */
+   long            minflt;           /* minor page faults of the checked run   */
+   long            majflt;           /* major page faults of the checked run   */
+   mem_growth_t    growth;           /* heap growth of the checked run         */
+   stats_summary_t tput;             /* ops per second                         */
+   double*         tput_samples;     /* ops per second of each repetition      */
+   op_latency_t    lat[ NKINDS ];
+   int             noisy;
+} trace_result_t;
+
+
+// ==========================
+// Private Global Variables
+// ==========================
+
+static const allocator_t* alloc   = NULL;
+static int                warmups = DEFAULT_WARMUPS;
+static int                reps    = DEFAULT_REPS;
+static int                cpu     = -1;
+static double             max_ci  = DEFAULT_MAX_CI;
+static int                verbose = 0;
+static const char*        json    = NULL;
+static FILE*              series  = NULL;   /* heap time series CSV, or NULL  */
+static int                interval = 0;     /* requests between CSV rows      */
+static aging_params_t     aging    = { 0, 0.25, 64, 1, 20 };   /* -A: epochs > 0 */
+static mem_config_t       memcfg;           /* memlib settings, -F -G -R -B -L -S -N -m -H */
+static long               cold_idle = 0;    /* -C: mm cold hints after idle requests */
+static mm_fit_t           fit       = MM_FIRST_FIT;   /* -f: mm placement policy   */
+static int                good_pct  = 0;    /* -g: mm best fit stops within this percent */
+static size_t             split_large = 0;  /* -b: mm places blocks this large at the end */
+static long               mmap_kb   = -1;   /* -M: mm maps requests this many KB; -1: default */
+static char               placement[ 96 ];  /* the four above, for the output   */
+
+static const char* const  kind_names[ NKINDS ] = { "all", "alloc", "free", "realloc" };
+static const double       pcts[ NPCTS ]        = { 50.0, 90.0, 99.0, 99.9 };
+
+
+// ==========================
+// Replay Helpers
+// ==========================
+
+/*
+ * reset_heap - give the allocator a fresh, empty heap
+ */
+static void reset_heap( void )
+{
+   if ( alloc->uses_memlib )
+      mem_reset_brk();
+
+   if ( alloc->init() < 0 )
+      app_error( "mdriver: allocator init failed" );
+}
+
+
+/*
+ * release_all - free the blocks a trace left allocated
+ */
+static void release_all( const trace_t* trace, char** ptrs )
+{
+   int i;
+
+   for ( i = 0; i < trace->num_ids; ++i )
+   {
+      if ( ptrs[ i ] != NULL )
+         alloc->free( ptrs[ i ] );
+      ptrs[ i ] = NULL;
+   }
+}
+
+
+/*
+ * do_request - issue one trace request
+ *
+ * Return: 0 if the allocator failed to satisfy the request, 1 otherwise
+ */
+static inline int do_request( const trace_op_t* p, char** ptrs )
+{
+   char* q;
+
+   switch ( p->type )
+   {
+      case ALLOC:
+         q = alloc->malloc( p->size );
+         if ( q == NULL && p->size != 0 )
+            return 0;
+         ptrs[ p->index ] = q;
+         break;
+
+      case REALLOC:
+         q = alloc->realloc( ptrs[ p->index ], p->size );
+         if ( q == NULL && p->size != 0 )
+            return 0;
+         ptrs[ p->index ] = q;
+         break;
+
+      case FREE:
+         alloc->free( ptrs[ p->index ] );
+         ptrs[ p->index ] = NULL;
+         break;
+   }
+
+   return 1;
+}
+
+
+/*
+ * replay - run a trace from start to finish on a fresh heap
+ *
+ * If lat is not NULL each request is timed individually and lat[i] receives
+ * the latency of request i in nanoseconds.
+ *
+ * Return: 0 if the allocator ran out of memory, 1 otherwise
+ */
+static int replay( const trace_t* trace, char** ptrs, double* lat )
+{
+   int ok = 1;
+   int i;
+
+   reset_heap();
+
+   for ( i = 0; i < trace->num_ops && ok; ++i )
+   {
+      if ( lat != NULL )
+      {
+         long long start = ftimer_ns();
+
+         ok      = do_request( &trace->ops[ i ], ptrs );
+         lat[ i ] = ( double )( ftimer_ns() - start );
+      }
+      else
+      {
+         ok = do_request( &trace->ops[ i ], ptrs );
+      }
+   }
+
+   release_all( trace, ptrs );
+   return ok;
+}
+
+
+// ==========================
+// Correctness and Utilization
+// ==========================
+
+/*
+ * sample_memory - track the peak resident bytes of the memlib region and
+ *                 append one row of the heap time series, if requested
+ *
+ * Heap size and resident bytes are left empty for allocators that do not
+ * use memlib.
+ */
+static void sample_memory( trace_result_t* res, int op, double live )
+{
+   size_t resident = alloc->uses_memlib ? mem_resident() : 0;
+
+   if ( resident > res->resident_peak )
+      res->resident_peak = resident;
+
+   if ( series == NULL )
+      return;
+
+   fprintf( series, "%s,%s,%d,", alloc->name, res->name, op );
+
+   if ( alloc->uses_memlib )
+      fprintf( series, "%zu,%.0f,%zu\n", mem_footprint(), live, resident );
+   else
+      fprintf( series, ",%.0f,\n", live );
+}
+
+
+static unsigned char fill_byte( int index )
+{
+   return ( unsigned char )( index * 31 + 7 );
+}
+
+
+/*
+ * check_block - check alignment and heap bounds of a freshly returned payload
+ */
+static int check_block( const char* tracename, int op, const char* p, int size )
+{
+   if ( ( uintptr_t )p % ALIGNMENT != 0 )
+   {
+      fprintf( stderr, "%s: request %d: payload %p is not %d-byte aligned\n", tracename, op, ( void* )p, ALIGNMENT );
+      return 0;
+   }
+
+   if ( alloc->uses_memlib && size > 0
+        && !mem_in_heap( p, size ) )
+   {
+      fprintf( stderr, "%s: request %d: payload [%p, %p) lies outside the heap\n",
+               tracename, op, ( void* )p, ( void* )( p + size ) );
+      return 0;
+   }
+
+   return 1;
+}
+
+
+/*
+ * check_fill - verify the first len bytes of a payload still hold its fill pattern
+ */
+static int check_fill( const char* tracename, int op, int index, const char* p, int len )
+{
+   unsigned char c = fill_byte( index );
+   int           i;
+
+   for ( i = 0; i < len; ++i )
+   {
+      if ( ( unsigned char )p[ i ] != c )
+      {
+         fprintf( stderr, "%s: request %d: payload of block %d was overwritten at byte %d\n",
+                  tracename, op, index, i );
+         return 0;
+      }
+   }
+
+   return 1;
+}
+
+
+/*
+ * eval_valid - replay a trace once, checking every payload
+ *
+ * Payloads are filled with a per-block byte pattern that is verified on
+ * realloc and free, which catches overlapping blocks and lost data.
+ *
+ * Every interval requests the resident bytes of the memlib region are
+ * sampled with mincore, and a time series row is written if requested.
+ * Page faults of the run are taken from getrusage.
+ *
+ * Return: 1 if the allocator handled the trace correctly, 0 otherwise
+ */
+static int eval_valid( const trace_t* trace, char** ptrs, trace_result_t* res )
+{
+   int*   sizes = ( int* )Calloc( trace->num_ids > 0 ? trace->num_ids : 1, sizeof( int ) );
+   double live  = 0.0;
+   double peak  = 0.0;
+   int    ok    = 1;
+   int    every = interval > 0 ? interval : ( trace->num_ops + SERIES_POINTS - 1 ) / SERIES_POINTS;
+   int    i;
+
+   struct rusage before;
+   struct rusage after;
+
+   reset_heap();
+   getrusage( RUSAGE_SELF, &before );
+   sample_memory( res, 0, 0.0 );
+
+   for ( i = 0; i < trace->num_ops && ok; ++i )
+   {
+      const trace_op_t* p       = &trace->ops[ i ];
+      char*             old     = ptrs[ p->index ];
+      int               oldsize = sizes[ p->index ];
+
+      if ( i > 0 && i % every == 0 )
+         sample_memory( res, i, live );
+
+      if ( p->type != ALLOC && old != NULL )
+         ok = check_fill( res->name, i, p->index, old, oldsize );
+      if ( !ok )
+         break;
+
+      if ( !do_request( p, ptrs ) )
+      {
+         fprintf( stderr, "%s: request %d: allocator returned NULL\n", res->name, i );
+         ok = 0;
+         break;
+      }
+
+      live -= oldsize;
+      sizes[ p->index ] = ( p->type == FREE ) ? 0 : p->size;
+      live += sizes[ p->index ];
+      if ( live > peak )
+         peak = live;
+
+      if ( p->type == FREE || ptrs[ p->index ] == NULL )
+         continue;
+
+      ok = check_block( res->name, i, ptrs[ p->index ], p->size );
+
+      if ( ok && p->type == REALLOC && old != NULL )
+         ok = check_fill( res->name, i, p->index, ptrs[ p->index ], oldsize < p->size ? oldsize : p->size );
+
+      if ( ok )
+         memset( ptrs[ p->index ], fill_byte( p->index ), p->size );
+   }
+
+   if ( ok )
+      sample_memory( res, trace->num_ops, live );
+
+   getrusage( RUSAGE_SELF, &after );
+   res->minflt = after.ru_minflt - before.ru_minflt;
+   res->majflt = after.ru_majflt - before.ru_majflt;
+
+   if ( alloc->uses_memlib )
+   {
+      mem_growth( &res->growth );
+      res->heapsize     = res->growth.peak_heap;
+      res->util         = res->heapsize > 0 ? peak / res->heapsize : 0.0;
+      res->resident_end = mem_resident();
+   }
+
+   release_all( trace, ptrs );
+   free( sizes );
+   return ok;
+}
+
+
+// ==========================
+// Measurement
+// ==========================
+
+/*
+ * kind_of - latency breakdown slot of a request
+ */
+static int kind_of( const trace_op_t* p )
+{
+   return 1 + ( int )p->type;
+}
+
+
+/*
+ * latency_percentiles - per-kind percentiles of one latency run
+ *
+ * pct[ k ][ j ] receives percentile pcts[ j ] of the requests of kind k.
+ */
+static void latency_percentiles( const trace_t* trace, const double* lat, double* buf,
+                                 double pct[ NKINDS ][ NPCTS ] )
+{
+   int k;
+   int i;
+   int j;
+
+   for ( k = 0; k < NKINDS; ++k )
+   {
+      int n = 0;
+
+      for ( i = 0; i < trace->num_ops; ++i )
+         if ( k == 0 || kind_of( &trace->ops[ i ] ) == k )
+            buf[ n++ ] = lat[ i ];
+
+      stats_sort( buf, n );
+      for ( j = 0; j < NPCTS; ++j )
+         pct[ k ][ j ] = stats_percentile( buf, n, pcts[ j ] );
+   }
+}
+
+
+/*
+ * measure - warm up, then collect throughput and latency samples for a trace
+ */
+static void measure( const trace_t* trace, char** ptrs, trace_result_t* res )
+{
+   int     nops = trace->num_ops > 0 ? trace->num_ops : 1;
+   double* lat  = ( double* )Calloc( nops, sizeof( double ) );
+   double* buf  = ( double* )Calloc( nops, sizeof( double ) );
+   double* pct  = ( double* )Calloc( ( size_t )reps * NKINDS * NPCTS, sizeof( double ) );
+   double  rep_pct[ NKINDS ][ NPCTS ];
+   int     r;
+   int     k;
+   int     j;
+   int     i;
+
+   res->tput_samples = ( double* )Calloc( reps, sizeof( double ) );
+   for ( k = 0; k < NKINDS; ++k )
+   {
+      res->lat[ k ].samples = ( double* )Calloc( reps, sizeof( double ) );
+      res->lat[ k ].count   = 0;
+   }
+   for ( i = 0; i < trace->num_ops; ++i )
+   {
+      ++res->lat[ 0 ].count;
+      ++res->lat[ kind_of( &trace->ops[ i ] ) ].count;
+   }
+
+   for ( r = 0; r < warmups; ++r )
+   {
+      replay( trace, ptrs, NULL );
+      replay( trace, ptrs, lat );
+   }
+
+   for ( r = 0; r < reps; ++r )
+   {
+      double start = ftimer_now();
+      double secs;
+      double sum[ NKINDS ] = { 0.0 };
+
+      replay( trace, ptrs, NULL );
+      secs = ftimer_now() - start;
+      res->tput_samples[ r ] = secs > 0.0 ? trace->num_ops / secs : 0.0;
+
+      replay( trace, ptrs, lat );
+      for ( i = 0; i < trace->num_ops; ++i )
+      {
+         sum[ 0 ] += lat[ i ];
+         sum[ kind_of( &trace->ops[ i ] ) ] += lat[ i ];
+      }
+      for ( k = 0; k < NKINDS; ++k )
+         res->lat[ k ].samples[ r ] = res->lat[ k ].count > 0 ? sum[ k ] / res->lat[ k ].count : 0.0;
+
+      latency_percentiles( trace, lat, buf, rep_pct );
+      for ( k = 0; k < NKINDS; ++k )
+         for ( j = 0; j < NPCTS; ++j )
+            pct[ ( k * NPCTS + j ) * reps + r ] = rep_pct[ k ][ j ];
+
+      if ( verbose )
+         printf( "  %s: rep %d: %.1f Kops/s, %.1f ns/op\n", res->name, r + 1,
+                 res->tput_samples[ r ] / 1e3, res->lat[ 0 ].samples[ r ] );
+   }
+
+   stats_summarize( res->tput_samples, reps, &res->tput );
+   for ( k = 0; k < NKINDS; ++k )
+   {
+      stats_summarize( res->lat[ k ].samples, reps, &res->lat[ k ].mean );
+      for ( j = 0; j < NPCTS; ++j )
+      {
+         stats_summary_t s;
+
+         stats_summarize( &pct[ ( k * NPCTS + j ) * reps ], reps, &s );
+         res->lat[ k ].pct[ j ] = s.median;
+      }
+   }
+
+   res->noisy = ( res->tput.mean > 0.0 && 100.0 * res->tput.ci95 / res->tput.mean > max_ci )
+             || ( res->lat[ 0 ].mean.mean > 0.0 && 100.0 * res->lat[ 0 ].mean.ci95 / res->lat[ 0 ].mean.mean > max_ci );
+
+   free( pct );
+   free( buf );
+   free( lat );
+}
+
+
+/*
+ * free_result - release the sample arrays of a trace result
+ */
+static void free_result( trace_result_t* res )
+{
+   int k;
+
+   free( res->tput_samples );
+   for ( k = 0; k < NKINDS; ++k )
+      free( res->lat[ k ].samples );
+}
+
+
+/*
+ * run_trace - evaluate one trace file
+ */
+static void run_trace( const char* filename, trace_result_t* res )
+{
+   trace_t*    trace = read_trace( filename );
+   char**      ptrs  = ( char** )Calloc( trace->num_ids > 0 ? trace->num_ids : 1, sizeof( char* ) );
+   const char* slash = strrchr( filename, '/' );
+
+   memset( res, 0, sizeof( *res ) );
+
+   /* Start every trace on a region that has never been touched, so that
+      its resident bytes and page faults are its own */
+   mem_deinit();
+   mem_init_config( &memcfg );
+
+   res->name    = slash ? slash + 1 : filename;
+   res->num_ops = trace->num_ops;
+   res->valid   = eval_valid( trace, ptrs, res );
+
+   if ( res->valid )
+      measure( trace, ptrs, res );
+
+   free( ptrs );
+   free_trace( trace );
+}
+
+
+// ==========================
+// Reporting
+// ==========================
+
+static double rel( double part, double whole )
+{
+   return whole > 0.0 ? 100.0 * part / whole : 0.0;
+}
+
+
+/*
+ * print_memory - heap size, resident bytes and page faults of the checked runs
+ */
+static void print_memory( const trace_result_t* results, int n )
+{
+   int i;
+
+   printf( "\n%-*s %12s %12s %12s %10s %8s %8s %8s %12s %10s %12s %12s %12s\n", NAME_WIDTH, "trace", "heap KB", "peak RSS KB",
+           "end RSS KB", "minflt", "majflt", "grows", "trims", "overgrow KB", "cold KB", "copied KB", "streamed KB",
+           "remapped KB" );
+
+   for ( i = 0; i < n; ++i )
+   {
+      const trace_result_t* r = &results[ i ];
+
+      if ( !r->valid )
+         continue;
+
+      if ( alloc->uses_memlib )
+         printf( "%-*.*s %12.1f %12.1f %12.1f", NAME_WIDTH, NAME_WIDTH, r->name,
+                 r->heapsize / 1024.0, r->resident_peak / 1024.0, r->resident_end / 1024.0 );
+      else
+         printf( "%-*.*s %12s %12s %12s", NAME_WIDTH, NAME_WIDTH, r->name, "-", "-", "-" );
+
+      printf( " %10ld %8ld", r->minflt, r->majflt );
+
+      if ( alloc->uses_memlib )
+         printf( " %8ld %8ld %12.1f %10.1f %12.1f %12.1f %12.1f\n", r->growth.grow_calls, r->growth.trim_calls,
+                 ( ( double )r->growth.grown - r->growth.requested ) / 1024.0,
+                 ( r->growth.cold + r->growth.paged_out ) / 1024.0,
+                 r->growth.copied / 1024.0, r->growth.streamed / 1024.0,
+                 ( r->growth.remapped + r->growth.moved ) / 1024.0 );
+      else
+         printf( " %8s %8s %12s %10s %12s %12s %12s\n", "-", "-", "-", "-", "-", "-", "-" );
+   }
+
+   for ( i = 0; i < n; ++i )
+   {
+      const mem_growth_t* g = &results[ i ].growth;
+
+      if ( g->limit_hits > 0 )
+         printf( "%s: heap limit reached %ld time(s), still exceeded after reclaiming %ld time(s)\n", results[ i ].name, g->limit_hits,
+                 g->limit_fails );
+   }
+}
+
+
+static void print_results( const trace_result_t* results, int n )
+{
+   double total_ops  = 0.0;
+   double total_secs = 0.0;
+   double util_sum   = 0.0;
+   int    nvalid     = 0;
+   int    noisy      = 0;
+   int    i;
+
+   printf( "\n%-*s %5s %7s %9s %11s %6s %7s %9s %6s %7s\n", NAME_WIDTH,
+           "trace", "valid", "util", "ops", "Kops/s", "sd", "95%CI", "ns/op", "sd", "95%CI" );
+
+   for ( i = 0; i < n; ++i )
+   {
+      const trace_result_t* r = &results[ i ];
+
+      if ( !r->valid )
+      {
+         printf( "%-*.*s %5s\n", NAME_WIDTH, NAME_WIDTH, r->name, "no" );
+         continue;
+      }
+
+      if ( alloc->uses_memlib )
+         printf( "%-*.*s %5s %6.1f%% %9d", NAME_WIDTH, NAME_WIDTH, r->name, "yes", 100.0 * r->util, r->num_ops );
+      else
+         printf( "%-*.*s %5s %7s %9d", NAME_WIDTH, NAME_WIDTH, r->name, "yes", "-", r->num_ops );
+
+      printf( " %11.1f %5.1f%% %6.2f%% %9.1f %5.1f%% %6.2f%%%s\n",
+              r->tput.median / 1e3, rel( r->tput.stddev, r->tput.mean ), rel( r->tput.ci95, r->tput.mean ),
+              r->lat[ 0 ].mean.median, rel( r->lat[ 0 ].mean.stddev, r->lat[ 0 ].mean.mean ),
+              rel( r->lat[ 0 ].mean.ci95, r->lat[ 0 ].mean.mean ),
+              r->noisy ? "  !" : "" );
+
+      ++nvalid;
+      noisy      += r->noisy;
+      util_sum   += r->util;
+      total_ops  += r->num_ops;
+      total_secs += r->tput.median > 0.0 ? r->num_ops / r->tput.median : 0.0;
+   }
+
+   if ( nvalid > 0 )
+   {
+      if ( alloc->uses_memlib )
+         printf( "%-*s %5s %6.1f%% %9.0f", NAME_WIDTH, "Total", "", 100.0 * util_sum / nvalid, total_ops );
+      else
+         printf( "%-*s %5s %7s %9.0f", NAME_WIDTH, "Total", "", "-", total_ops );
+      printf( " %11.1f\n", total_secs > 0.0 ? total_ops / total_secs / 1e3 : 0.0 );
+   }
+
+   print_memory( results, n );
+
+   if ( noisy )
+      printf( "\n! %d trace(s) have a 95%% confidence interval wider than %.2f%% of the mean;\n"
+              "  add repetitions or quiet the machine before comparing them.\n", noisy, max_ci );
+}
+
+
+static void json_samples( FILE* fp, const double* samples )
+{
+   int r;
+
+   fprintf( fp, "[" );
+   for ( r = 0; r < reps; ++r )
+      fprintf( fp, "%s%.6g", r ? ", " : "", samples[ r ] );
+   fprintf( fp, "]" );
+}
+
+
+static void json_summary( FILE* fp, const stats_summary_t* s, const double* samples )
+{
+   fprintf( fp, "{ \"median\": %.6g, \"mean\": %.6g, \"stddev\": %.6g, \"ci95\": %.6g, \"samples\": ",
+            s->median, s->mean, s->stddev, s->ci95 );
+   json_samples( fp, samples );
+   fprintf( fp, " }" );
+}
+
+
+static void json_name( FILE* fp, const char* name )
+{
+   fputc( '"', fp );
+   for ( ; *name != '\0'; ++name )
+   {
+      if ( *name == '"' || *name == '\\' )
+         fputc( '\\', fp );
+      fputc( *name, fp );
+   }
+   fputc( '"', fp );
+}
+
+
+/*
+ * write_json - write the results in machine-readable form for mdcompare
+ */
+static void write_json( const char* filename, const trace_result_t* results, int n )
+{
+   FILE* fp = Fopen( filename, "w" );
+   int   i;
+   int   k;
+   int   j;
+
+   fprintf( fp, "{\n  \"allocator\": " );
+   json_name( fp, alloc->name );
+   fprintf( fp, ",\n  \"placement\": " );
+   json_name( fp, placement );
+   fprintf( fp, ",\n  \"uses_memlib\": %s,\n  \"warmups\": %d,\n  \"reps\": %d,\n  \"cpu\": %d,\n  \"traces\": [",
+            alloc->uses_memlib ? "true" : "false", warmups, reps, cpu );
+
+   for ( i = 0; i < n; ++i )
+   {
+      const trace_result_t* r = &results[ i ];
+
+      fprintf( fp, "%s\n    {\n      \"name\": ", i ? "," : "" );
+      json_name( fp, r->name );
+      fprintf( fp, ",\n      \"valid\": %s,\n      \"ops\": %d", r->valid ? "true" : "false", r->num_ops );
+
+      if ( alloc->uses_memlib )
+         fprintf( fp, ",\n      \"util\": %.6g,\n      \"peak_heapsize\": %zu,"
+                      "\n      \"resident_peak\": %zu,\n      \"resident_end\": %zu",
+                  r->util, r->heapsize, r->resident_peak, r->resident_end );
+
+      if ( alloc->uses_memlib )
+         fprintf( fp, ",\n      \"grow_calls\": %ld,\n      \"trim_calls\": %ld,"
+                      "\n      \"grown_bytes\": %zu,\n      \"requested_bytes\": %zu,"
+                      "\n      \"cold_bytes\": %zu,\n      \"paged_out_bytes\": %zu,"
+                      "\n      \"limit_hits\": %ld,\n      \"limit_fails\": %ld,"
+                      "\n      \"copied_bytes\": %zu,\n      \"streamed_bytes\": %zu,"
+                      "\n      \"remaps\": %ld,\n      \"remapped_bytes\": %zu,\n      \"moved_bytes\": %zu",
+                  r->growth.grow_calls, r->growth.trim_calls, r->growth.grown, r->growth.requested,
+                  r->growth.cold, r->growth.paged_out, r->growth.limit_hits, r->growth.limit_fails,
+                  r->growth.copied, r->growth.streamed, r->growth.remaps, r->growth.remapped,
+                  r->growth.moved );
+
+      fprintf( fp, ",\n      \"minor_faults\": %ld,\n      \"major_faults\": %ld", r->minflt, r->majflt );
+
+      if ( !r->valid )
+      {
+         fprintf( fp, "\n    }" );
+         continue;
+      }
+
+      fprintf( fp, ",\n      \"noisy\": %s,\n      \"throughput\": ", r->noisy ? "true" : "false" );
+      json_summary( fp, &r->tput, r->tput_samples );
+      fprintf( fp, ",\n      \"latency\": {" );
+
+      for ( k = 0; k < NKINDS; ++k )
+      {
+         const op_latency_t* l = &r->lat[ k ];
+
+         fprintf( fp, "%s\n        \"%s\": { \"count\": %ld, \"ops_per_sec\": %.6g,",
+                  k ? "," : "", kind_names[ k ], l->count, l->mean.median > 0.0 ? 1e9 / l->mean.median : 0.0 );
+         for ( j = 0; j < NPCTS; ++j )
+            fprintf( fp, " \"p%g\": %.6g,", pcts[ j ], l->pct[ j ] );
+         fprintf( fp, "\n          \"mean_ns\": " );
+         json_summary( fp, &l->mean, l->samples );
+         fprintf( fp, " }" );
+      }
+
+      fprintf( fp, "\n      }\n    }" );
+   }
+
+   fprintf( fp, "\n  ]\n}\n" );
+   Fclose( fp );
+}
+
+
+// ==========================
+// Main Routine
+// ==========================
+
+/*
+ * age_traces - run the aging simulation on every trace
+ */
+static void age_traces( char* filenames[], int n )
+{
+   int i;
+
+   for ( i = 0; i < n; ++i )
+   {
+      trace_t*    trace = read_trace( filenames[ i ] );
+      const char* slash = strrchr( filenames[ i ], '/' );
+
+      mem_deinit();
+      mem_init_config( &memcfg );
+      age_trace( alloc, trace, slash ? slash + 1 : filenames[ i ], &aging, series );
+      free_trace( trace );
+   }
+
+   if ( series != NULL )
+      Fclose( series );
+   mem_deinit();
+}
+
+
+static void pin_cpu( int which )
+{
+   cpu_set_t set;
+
+   CPU_ZERO( &set );
+   CPU_SET( which, &set );
+
+   if ( sched_setaffinity( 0, sizeof( set ), &set ) < 0 )
+      unix_error( "mdriver: sched_setaffinity error" );
+}
+
+
+static void usage( const char* prog )
+{
+   const allocator_t* a;
+
+   fprintf( stderr, "usage: %s [-hv] [-a <allocator>] [-w <warmups>] [-n <reps>] [-c <cpu>] [-x <percent>] [-j <file>]\n"
+                    "       [-T <file> [-i <requests>]] [-A <epochs> [-P <percent>] [-D <requests>]]\n"
+                    "       [-F <sbrk|all>] [-G <KB>] [-R] [-B <addr|fixed>] [-L <KB>]\n"
+                    "       [-C <requests>] [-S <KB>] [-N <KB>] [-f <first|next|best> [-g <percent>]] [-b <bytes>]\n"
+                    "       [-M <KB>] [-m] [-H <MB>]\n"
+                    "       <tracefile>...\n", prog );
+   fprintf( stderr, "  -a <allocator>  allocator to benchmark (default mm)\n" );
+   fprintf( stderr, "  -w <warmups>    unmeasured runs per trace (default %d)\n", DEFAULT_WARMUPS );
+   fprintf( stderr, "  -n <reps>       measured runs per trace (default %d)\n", DEFAULT_REPS );
+   fprintf( stderr, "  -c <cpu>        pin the driver to a cpu\n" );
+   fprintf( stderr, "  -x <percent>    flag traces whose 95%% CI exceeds this share of the mean (default %.1f)\n", DEFAULT_MAX_CI );
+   fprintf( stderr, "  -j <file>       also write the results as JSON to file\n" );
+   fprintf( stderr, "  -T <file>       write a CSV time series of heap size, live and resident bytes\n" );
+   fprintf( stderr, "  -i <requests>   requests between time series rows (default: %d rows per trace)\n", SERIES_POINTS );
+   fprintf( stderr, "  -A <epochs>     instead of benchmarking, age the heap over this many passes\n"
+                    "                  of each trace's steady-state window\n" );
+   fprintf( stderr, "  -P <percent>    aging: perturb request sizes by up to this much (default 25)\n" );
+   fprintf( stderr, "  -D <requests>   aging: defer frees by up to this many requests (default 64)\n" );
+   fprintf( stderr, "  -F <sbrk|all>   pre-fault heap pages in mem_sbrk, or the whole heap at init\n" );
+   fprintf( stderr, "  -G <KB>         keep this much heap above the brk pre-faulted by a background thread\n" );
+   fprintf( stderr, "  -R              give heap pages back to the OS when the heap is trimmed or reset\n" );
+   fprintf( stderr, "  -B <addr|fixed> map the heap at this address (fixed: %p) for reproducible layouts\n", MEM_FIXED_BASE );
+   fprintf( stderr, "  -L <KB>         align the start of the heap to this many KB\n" );
+   fprintf( stderr, "  -C <requests>   mm: hint free blocks idle this long as cold (paged out under pressure)\n" );
+   fprintf( stderr, "  -S <KB>         soft heap limit: purge the allocator and trim before failing\n" );
+   fprintf( stderr, "  -N <KB>         realloc copies this large use non-temporal stores (default: half the LLC)\n" );
+   fprintf( stderr, "  -f <policy>     mm: first, next (rover) or best fit placement (default first)\n" );
+   fprintf( stderr, "  -g <percent>    mm best fit: stop at a block no more than this much too large\n" );
+   fprintf( stderr, "  -b <bytes>      mm: place blocks this large at the end of the free block they split\n" );
+   fprintf( stderr, "  -M <KB>         mm: give requests this large a mapping resized with mremap (default 1024, 0: off)\n" );
+   fprintf( stderr, "  -m              back the heap with a memfd; mm realloc moves the pages of heap blocks of %d MB or more\n",
+            MM_MOVE_MIN >> 20 );
+   fprintf( stderr, "  -H <MB>         heap size (default %zu)\n", memcfg.max_heap >> 20 );
+   fprintf( stderr, "  -v              print every repetition\n" );
+   fprintf( stderr, "  -h              print this message\n" );
+   fprintf( stderr, "allocators:\n" );
+   for ( a = allocators; a->name != NULL; ++a )
+      fprintf( stderr, "  %-14s %s\n", a->name, a->description );
+}
+
+
+int main( int argc, char* argv[] )
+{
+   trace_result_t* results;
+   int             ntraces;
+   int             c;
+   int             i;
+
+   alloc = find_allocator( "mm" );
+   mem_config_default( &memcfg );
+
+   while ( ( c = getopt( argc, argv, "hva:w:n:c:x:j:T:i:A:P:D:F:G:RB:L:C:S:f:g:b:N:M:mH:" ) ) != -1 )
+   {
+      switch ( c )
+      {
+         case 'a':
+            if ( ( alloc = find_allocator( optarg ) ) == NULL )
+            {
+               usage( argv[ 0 ] );
+               exit( EXIT_FAILURE );
+            }
+            break;
+         case 'w':
+            warmups = atoi( optarg );
+            break;
+         case 'n':
+            reps = atoi( optarg );
+            break;
+         case 'c':
+            cpu = atoi( optarg );
+            break;
+         case 'x':
+            max_ci = atof( optarg );
+            break;
+         case 'j':
+            json = optarg;
+            break;
+         case 'T':
+            series = Fopen( optarg, "w" );
+            fprintf( series, "allocator,trace,op,heapsize,live_bytes,resident_bytes\n" );
+            break;
+         case 'i':
+            interval = atoi( optarg );
+            break;
+         case 'A':
+            aging.epochs = atol( optarg );
+            break;
+         case 'P':
+            aging.size_jitter = atof( optarg ) / 100.0;
+            break;
+         case 'D':
+            aging.free_delay = atoi( optarg );
+            break;
+         case 'F':
+            if ( strcmp( optarg, "sbrk" ) == 0 )
+               memcfg.prefault = MEM_PREFAULT_SBRK;
+            else if ( strcmp( optarg, "all" ) == 0 )
+               memcfg.prefault = MEM_PREFAULT_ALL;
+            else
+               app_error( "mdriver: -F takes sbrk or all" );
+            break;
+         case 'G':
+            memcfg.prefault_ahead = ( size_t )atol( optarg ) << 10;
+            break;
+         case 'R':
+            memcfg.release_pages = 1;
+            break;
+         case 'B':
+            memcfg.base_addr = strcmp( optarg, "fixed" ) == 0 ? MEM_FIXED_BASE
+                                                              : ( void* )( uintptr_t )strtoull( optarg, NULL, 0 );
+            break;
+         case 'L':
+            memcfg.align = ( size_t )atol( optarg ) << 10;
+            break;
+         case 'C':
+            cold_idle = atol( optarg );
+            break;
+         case 'S':
+            memcfg.soft_limit = ( size_t )atol( optarg ) << 10;
+            break;
+         case 'N':
+            memcfg.stream_min = ( size_t )atol( optarg ) << 10;
+            break;
+         case 'f':
+            if ( strcmp( optarg, "first" ) == 0 )
+               fit = MM_FIRST_FIT;
+            else if ( strcmp( optarg, "next" ) == 0 )
+               fit = MM_NEXT_FIT;
+            else if ( strcmp( optarg, "best" ) == 0 )
+               fit = MM_BEST_FIT;
+            else
+               app_error( "mdriver: -f takes first, next or best" );
+            break;
+         case 'g':
+            good_pct = atoi( optarg );
+            break;
+         case 'b':
+            split_large = ( size_t )atol( optarg );
+            break;
+         case 'M':
+            mmap_kb = atol( optarg );
+            break;
+         case 'm':
+            memcfg.memfd = 1;
+            break;
+         case 'H':
+            memcfg.max_heap = ( size_t )atol( optarg ) << 20;
+            break;
+         case 'v':
+            verbose = 1;
+            break;
+         case 'h':
+            usage( argv[ 0 ] );
+            exit( EXIT_SUCCESS );
+         default:
+            usage( argv[ 0 ] );
+            exit( EXIT_FAILURE );
+      }
+   }
+
+   if ( warmups < 0 || reps < 1 )
+      app_error( "mdriver: need at least one repetition and no negative warm-ups" );
+
+   if ( aging.epochs < 0 || aging.size_jitter < 0.0 || aging.size_jitter >= 1.0 || aging.free_delay < 0 )
+      app_error( "mdriver: invalid aging parameters" );
+
+   if ( ( memcfg.align & ( memcfg.align - 1 ) ) != 0 )
+      app_error( "mdriver: -L takes a power of two" );
+
+   if ( memcfg.max_heap == 0 )
+      app_error( "mdriver: -H takes a size in MB" );
+
+   if ( optind >= argc )
+   {
+      usage( argv[ 0 ] );
+      exit( EXIT_FAILURE );
+   }
+
+   if ( cpu >= 0 )
+      pin_cpu( cpu );
+
+   if ( cold_idle < 0 )
+      app_error( "mdriver: -C takes a number of requests" );
+   mm_set_cold( cold_idle );
+
+   if ( good_pct < 0 || ( good_pct > 0 && fit != MM_BEST_FIT ) )
+      app_error( "mdriver: -g takes a percentage and needs -f best" );
+   mm_set_fit( fit, good_pct );
+   mm_set_split( split_large );
+
+   if ( mmap_kb < -1 )
+      app_error( "mdriver: -M takes a size in KB" );
+   if ( mmap_kb >= 0 )
+      mm_set_mmap( ( size_t )mmap_kb << 10 );
+
+   snprintf( placement, sizeof( placement ), "%s fit", fit == MM_NEXT_FIT ? "next" : fit == MM_BEST_FIT ? "best" : "first" );
+   if ( good_pct > 0 )
+      snprintf( placement + strlen( placement ), sizeof( placement ) - strlen( placement ), ", within %d%%", good_pct );
+   if ( split_large > 0 )
+      snprintf( placement + strlen( placement ), sizeof( placement ) - strlen( placement ), ", %zu+ bytes at the end", split_large );
+   if ( mmap_kb >= 0 )
+      snprintf( placement + strlen( placement ), sizeof( placement ) - strlen( placement ), ", %ld+ KB mapped", mmap_kb );
+
+   mem_init_config( &memcfg );
+
+   printf( "Allocator %s: %s\n", alloc->name, alloc->description );
+   if ( fit != MM_FIRST_FIT || split_large > 0 || mmap_kb >= 0 )
+      printf( "mm placement: %s\n", placement );
+   if ( memcfg.memfd )
+      printf( "heap of %zu MB backed by a memfd, mm heap blocks of %d MB or more moved by remapping pages\n",
+              memcfg.max_heap >> 20, MM_MOVE_MIN >> 20 );
+   if ( memcfg.base_addr != NULL || memcfg.align > 0 )
+      printf( "heap at %p, aligned to %zu KB\n", mem_heap_lo(), ( memcfg.align ? memcfg.align : mem_pagesize() ) >> 10 );
+   if ( memcfg.prefault != MEM_PREFAULT_NONE || memcfg.prefault_ahead > 0 )
+      printf( "heap pages pre-faulted %s, %zu KB kept ahead of the brk\n",
+              memcfg.prefault == MEM_PREFAULT_ALL ? "at init" : memcfg.prefault == MEM_PREFAULT_SBRK ? "by mem_sbrk" : "on demand",
+              memcfg.prefault_ahead >> 10 );
+   if ( aging.epochs == 0 )
+   {
+      printf( "%d warm-up and %d measured run(s) per trace", warmups, reps );
+      if ( cpu >= 0 )
+         printf( ", pinned to cpu %d", cpu );
+      printf( "\n" );
+   }
+   else if ( cpu >= 0 )
+   {
+      printf( "pinned to cpu %d\n", cpu );
+   }
+
+   ntraces = argc - optind;
+
+   if ( aging.epochs > 0 )
+   {
+      age_traces( argv + optind, ntraces );
+      return EXIT_SUCCESS;
+   }
+
+   results = ( trace_result_t* )Calloc( ntraces, sizeof( trace_result_t ) );
+
+   for ( i = 0; i < ntraces; ++i )
+      run_trace( argv[ optind + i ], &results[ i ] );
+
+   print_results( results, ntraces );
+
+   if ( json != NULL )
+      write_json( json, results, ntraces );
+
+   if ( series != NULL )
+      Fclose( series );
+
+   for ( i = 0; i < ntraces; ++i )
+      free_result( &results[ i ] );
+   free( results );
+   mem_deinit();
+
+   return EXIT_SUCCESS;
+}
\ No newline at end of file
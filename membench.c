@@ -0,0 +1,513 @@
+/**
+ * @file    membench.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Microbenchmarks of the memlib memory system model
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Measures what growing the heap through memlib really costs, so that the
+ * growth policy of an allocator can be tuned against it:
+ *
+ *    - sbrk:  mem_sbrk calls per second for increments from 16 bytes to
+ *             1 MB, without touching the memory
+ *    - touch: cost per page of the first write to newly extended memory
+ *             (a page fault) and of a second write to the same pages
+ *    - reset: cost of mem_reset_brk, and of touching the heap again after
+ *             it, with the pages kept and with the pages released to the OS
+ *    - thp:   first touch and random access cost with transparent huge
+ *             pages disabled and enabled for the heap
+ *    - grow:  latency of growing the heap by a page and writing to it, with
+ *             pages faulted on first write, pre-faulted by mem_sbrk, by
+ *             mem_init, or ahead of the brk by the pre-growth thread
+ *    - vbuf:  appending to a growable buffer a page at a time: a vbuf, and
+ *             an mm block doubled by mm_realloc, with huge blocks copied
+ *             or remapped
+ *
+ * Each figure is the median of the repetitions. Minor page faults are
+ * taken from getrusage.
+ *
+ * usage: membench [-h] [-m <heap MB>] [-r <reps>] [-g <KB ahead>]
+ */
+#include "ftimer.h"
+#include "memlib.h"
+#include "stats.h"
+#include "std_wrappers.h"
+#include "vbuf.h"
+#include "mm.h"
+
+#include <stdio.h>          // printf, fprintf
+#include <stdlib.h>         // atoi, atol, exit, free
+#include <string.h>         // memset
+
+#include <sys/resource.h>   // getrusage, RUSAGE_SELF
+#include <unistd.h>         // getopt, optarg
+
+
+// =======================
+// Constants and Macros
+// =======================
+
+#define DEFAULT_HEAP_MB 256
+#define DEFAULT_REPS    5
+#define MAX_REPS        64
+#define MAX_SBRK_CALLS  ( 1 << 20 )
+#define RANDOM_ACCESSES ( 1 << 22 )
+#define DEFAULT_AHEAD_KB 1024
+
+
+// ==========================
+// Private Global Variables
+// ==========================
+
+static size_t heap_bytes = ( size_t )DEFAULT_HEAP_MB << 20;
+static int    reps       = DEFAULT_REPS;
+static size_t ahead      = ( size_t )DEFAULT_AHEAD_KB << 10;
+
+
+// ==========================
+// Private Helper Functions
+// ==========================
+
+static long minor_faults( void )
+{
+   struct rusage ru;
+
+   getrusage( RUSAGE_SELF, &ru );
+   return ru.ru_minflt;
+}
+
+
+static double median( double* samples, int n )
+{
+   stats_summary_t s;
+
+   stats_summarize( samples, n, &s );
+   return s.median;
+}
+
+
+/*
+ * start - set up memlib with the given page release and huge page settings
+ */
+static void start( int release_pages, mem_thp_t huge_pages )
+{
+   mem_config_t config;
+
+   mem_config_default( &config );
+   config.max_heap      = heap_bytes;
+   config.release_pages = release_pages;
+   config.huge_pages    = huge_pages;
+   mem_init_config( &config );
+}
+
+
+/*
+ * start_prefault - set up memlib with the given pre-fault settings, huge pages off
+ */
+static void start_prefault( mem_prefault_t prefault, size_t prefault_ahead )
+{
+   mem_config_t config;
+
+   mem_config_default( &config );
+   config.max_heap       = heap_bytes;
+   config.huge_pages     = MEM_THP_NEVER;
+   config.prefault       = prefault;
+   config.prefault_ahead = prefault_ahead;
+   mem_init_config( &config );
+}
+
+
+/*
+ * touch - write one byte in every page of [lo, lo + len)
+ *
+ * Return: the elapsed time in seconds
+ */
+static double touch( char* lo, size_t len )
+{
+   volatile char* p    = lo;
+   size_t         step = mem_pagesize();
+   double         t    = ftimer_now();
+   size_t         i;
+
+   for ( i = 0; i < len; i += step )
+      p[ i ] = ( char )i;
+
+   return ftimer_now() - t;
+}
+
+
+/*
+ * random_reads - read RANDOM_ACCESSES random bytes of [lo, lo + len)
+ *
+ * Return: the elapsed time in seconds
+ */
+static double random_reads( const char* lo, size_t len )
+{
+   const volatile char* p    = lo;
+   unsigned             seed = 1;
+   long                 sum  = 0;
+   double               t    = ftimer_now();
+   int                  i;
+
+   for ( i = 0; i < RANDOM_ACCESSES; ++i )
+   {
+      seed ^= seed << 13;
+      seed ^= seed >> 17;
+      seed ^= seed << 5;
+      sum  += p[ seed % len ];
+   }
+
+   t = ftimer_now() - t;
+   return sum == -1 ? 0.0 : t;      /* keep the reads */
+}
+
+
+/*
+ * grow - extend the empty heap to len bytes in one call
+ */
+static char* grow( size_t len )
+{
+   char* p = ( char* )mem_sbrk( ( int )len );
+
+   if ( p == ( char* )-1 )
+      app_error( "membench: mem_sbrk failed" );
+
+   return p;
+}
+
+
+// ==========================
+// Benchmarks
+// ==========================
+
+static void bench_sbrk( void )
+{
+   static const int incrs[] = { 16, 64, 256, 4096, 65536, 1 << 20 };
+   double           samples[ MAX_REPS ];
+   unsigned         k;
+   int              r;
+
+   printf( "\nmem_sbrk throughput (memory not touched)\n" );
+   printf( "%12s %10s %12s %14s\n", "increment", "calls", "ns/call", "Mcalls/s" );
+
+   start( 0, MEM_THP_DEFAULT );
+
+   for ( k = 0; k < sizeof( incrs ) / sizeof( incrs[ 0 ] ); ++k )
+   {
+      long calls = ( long )( heap_bytes / incrs[ k ] );
+      double ns;
+
+      if ( calls > MAX_SBRK_CALLS )
+         calls = MAX_SBRK_CALLS;
+
+      for ( r = 0; r < reps; ++r )
+      {
+         long long t;
+         long      i;
+
+         mem_reset_brk();
+         t = ftimer_ns();
+         for ( i = 0; i < calls; ++i )
+            mem_sbrk( incrs[ k ] );
+         samples[ r ] = ( double )( ftimer_ns() - t ) / calls;
+      }
+
+      ns = median( samples, reps );
+      printf( "%12d %10ld %12.2f %14.1f\n", incrs[ k ], calls, ns, ns > 0.0 ? 1e3 / ns : 0.0 );
+   }
+
+   mem_deinit();
+}
+
+
+static void bench_touch( void )
+{
+   double first[ MAX_REPS ];
+   double again[ MAX_REPS ];
+   size_t pages = heap_bytes / mem_pagesize();
+   long   faults = 0;
+   int    r;
+
+   for ( r = 0; r < reps; ++r )
+   {
+      char* p;
+      long  f;
+
+      start( 0, MEM_THP_NEVER );
+      p = grow( heap_bytes );
+
+      f          = minor_faults();
+      first[ r ] = 1e9 * touch( p, heap_bytes ) / pages;
+      faults    += minor_faults() - f;
+      again[ r ] = 1e9 * touch( p, heap_bytes ) / pages;
+
+      mem_deinit();
+   }
+
+   printf( "\nPage commit cost (%zu pages of %zu bytes, huge pages off)\n", pages, mem_pagesize() );
+   printf( "%-24s %10.1f ns/page, %.2f faults/page\n", "first touch", median( first, reps ),
+           ( double )faults / reps / pages );
+   printf( "%-24s %10.1f ns/page\n", "second touch", median( again, reps ) );
+}
+
+
+static void bench_reset( void )
+{
+   static const char* const names[] = { "keep pages", "release pages" };
+   double                   reset[ MAX_REPS ];
+   double                   retouch[ MAX_REPS ];
+   size_t                   pages = heap_bytes / mem_pagesize();
+   int                      release;
+   int                      r;
+
+   printf( "\nmem_reset_brk of a fully touched %zu MB heap\n", heap_bytes >> 20 );
+   printf( "%-16s %14s %16s %14s\n", "mode", "reset us", "retouch ns/pg", "faults/page" );
+
+   for ( release = 0; release <= 1; ++release )
+   {
+      long faults = 0;
+
+      start( release, MEM_THP_NEVER );
+
+      for ( r = 0; r < reps; ++r )
+      {
+         double t;
+         char*  p;
+         long   f;
+
+         mem_reset_brk();
+         touch( grow( heap_bytes ), heap_bytes );
+
+         t          = ftimer_now();
+         mem_reset_brk();
+         reset[ r ] = 1e6 * ( ftimer_now() - t );
+
+         p            = grow( heap_bytes );
+         f            = minor_faults();
+         retouch[ r ] = 1e9 * touch( p, heap_bytes ) / pages;
+         faults      += minor_faults() - f;
+      }
+
+      printf( "%-16s %14.1f %16.1f %14.2f\n", names[ release ], median( reset, reps ), median( retouch, reps ),
+              ( double )faults / reps / pages );
+
+      mem_deinit();
+   }
+}
+
+
+static void bench_thp( void )
+{
+   static const char* const names[]  = { "huge pages off", "huge pages on" };
+   static const mem_thp_t   modes[]  = { MEM_THP_NEVER, MEM_THP_ALWAYS };
+   double                   first[ MAX_REPS ];
+   double                   reads[ MAX_REPS ];
+   size_t                   pages = heap_bytes / mem_pagesize();
+   int                      m;
+   int                      r;
+
+   printf( "\nTransparent huge pages (%zu KB) on a %zu MB heap\n", mem_hugepagesize() >> 10, heap_bytes >> 20 );
+   printf( "%-16s %16s %14s %16s\n", "mode", "first ns/page", "faults/page", "random read ns" );
+
+   for ( m = 0; m < 2; ++m )
+   {
+      long faults = 0;
+
+      for ( r = 0; r < reps; ++r )
+      {
+         char* p;
+         long  f;
+
+         start( 0, modes[ m ] );
+         p = grow( heap_bytes );
+
+         f          = minor_faults();
+         first[ r ] = 1e9 * touch( p, heap_bytes ) / pages;
+         faults    += minor_faults() - f;
+         reads[ r ] = 1e9 * random_reads( p, heap_bytes ) / RANDOM_ACCESSES;
+
+         mem_deinit();
+      }
+
+      printf( "%-16s %16.1f %14.3f %16.2f\n", names[ m ], median( first, reps ),
+              ( double )faults / reps / pages, median( reads, reps ) );
+   }
+}
+
+
+static void bench_grow( void )
+{
+   static const char* const      names[]    = { "on first write", "by mem_sbrk", "at init", "ahead of brk" };
+   static const mem_prefault_t   prefault[] = { MEM_PREFAULT_NONE, MEM_PREFAULT_SBRK, MEM_PREFAULT_ALL, MEM_PREFAULT_NONE };
+   size_t                        pagesize   = mem_pagesize();
+   int                           npages     = ( int )( heap_bytes / pagesize );
+   double*                       lat        = ( double* )Malloc( npages * sizeof( double ) );
+   unsigned                      m;
+
+   printf( "\nGrowing the heap a page at a time and writing to it (%zu KB kept ahead)\n", ahead >> 10 );
+   printf( "%-16s %10s %10s %10s %10s\n", "pre-fault", "init ms", "p50 ns", "p99 ns", "max us" );
+
+   for ( m = 0; m < sizeof( names ) / sizeof( names[ 0 ] ); ++m )
+   {
+      double t = ftimer_now();
+      int    i;
+
+      start_prefault( prefault[ m ], m == 3 ? ahead : 0 );
+      t = 1e3 * ( ftimer_now() - t );
+
+      for ( i = 0; i < npages; ++i )
+      {
+         long long t0 = ftimer_ns();
+         char*     p  = ( char* )mem_sbrk( ( int )pagesize );
+
+         *( volatile char* )p = 1;
+         lat[ i ] = ( double )( ftimer_ns() - t0 );
+      }
+
+      stats_sort( lat, npages );
+      printf( "%-16s %10.2f %10.0f %10.0f %10.1f\n", names[ m ], t, stats_percentile( lat, npages, 50.0 ),
+              stats_percentile( lat, npages, 99.0 ), lat[ npages - 1 ] / 1e3 );
+
+      mem_deinit();
+   }
+
+   free( lat );
+}
+
+
+/*
+ * append_mm - append len bytes a page at a time to an mm block whose
+ *             capacity doubles to mm_good_size, huge blocks from mmap_min
+ *             bytes on in a mapping of their own (0: never)
+ *
+ * Return: the elapsed time in seconds; *copied is set to the bytes copied
+ */
+static double append_mm( size_t len, size_t mmap_min, size_t* copied )
+{
+   size_t       page = mem_pagesize();
+   size_t       cap  = page;
+   size_t       used;
+   char*        buf;
+   double       t;
+   mem_growth_t g;
+
+   start( 0, MEM_THP_NEVER );
+   mm_set_mmap( mmap_min );
+   if ( mm_init() < 0 )
+      app_error( "membench: mm_init failed" );
+
+   t   = ftimer_now();
+   buf = ( char* )mm_malloc( cap );
+   cap = mm_usable_size( buf );
+   for ( used = 0; used < len; used += page )
+   {
+      if ( used + page > cap && ( buf = ( char* )mm_realloc( buf, cap = mm_good_size( 2 * cap ) ) ) == NULL )
+         app_error( "membench: mm_realloc failed" );
+      memset( buf + used, ( int )used, page );
+   }
+   t = ftimer_now() - t;
+
+   mem_growth( &g );
+   *copied = g.copied;
+   mem_deinit();
+   return t;
+}
+
+
+/*
+ * append_vbuf - append len bytes a page at a time to a vbuf
+ *
+ * Return: the elapsed time in seconds
+ */
+static double append_vbuf( size_t len )
+{
+   size_t page = mem_pagesize();
+   size_t used;
+   vbuf_t b;
+   double t;
+
+   if ( vbuf_init( &b, len ) < 0 )
+      unix_error( "membench: vbuf_init error" );
+
+   t = ftimer_now();
+   for ( used = 0; used < len; used += page )
+      memset( vbuf_extend( &b, page ), ( int )used, page );
+   t = ftimer_now() - t;
+
+   vbuf_free( &b );
+   return t;
+}
+
+
+static void bench_vbuf( void )
+{
+   static const char* const names[] = { "vbuf", "mm, copied", "mm, remapped" };
+   size_t                   len     = heap_bytes / 4;   /* mm needs room for old and new */
+   double                   ms[ MAX_REPS ];
+   size_t                   copied  = 0;
+   int                      m;
+   int                      r;
+
+   printf( "\nAppending %zu MB a page at a time to a growable buffer\n", len >> 20 );
+   printf( "%-16s %10s %12s\n", "buffer", "ms", "copied MB" );
+
+   for ( m = 0; m < 3; ++m )
+   {
+      for ( r = 0; r < reps; ++r )
+         ms[ r ] = 1e3 * ( m == 0 ? append_vbuf( len ) : append_mm( len, m == 1 ? 0 : 1 << 20, &copied ) );
+
+      printf( "%-16s %10.2f %12.1f\n", names[ m ], median( ms, reps ), ( double )copied / ( 1 << 20 ) );
+   }
+
+   mm_set_mmap( 1 << 20 );
+}
+
+
+static void usage( const char* prog )
+{
+   fprintf( stderr, "usage: %s [-h] [-m <heap MB>] [-r <reps>] [-g <KB ahead>]\n", prog );
+   fprintf( stderr, "  -m <heap MB>  size of the heap to grow and touch (default %d)\n", DEFAULT_HEAP_MB );
+   fprintf( stderr, "  -r <reps>     repetitions of each measurement (default %d, at most %d)\n", DEFAULT_REPS, MAX_REPS );
+   fprintf( stderr, "  -g <KB>       heap the pre-growth thread keeps faulted above the brk (default %d)\n", DEFAULT_AHEAD_KB );
+   fprintf( stderr, "  -h            print this message\n" );
+}
+
+
+int main( int argc, char* argv[] )
+{
+   int mb = DEFAULT_HEAP_MB;
+   int c;
+
+   while ( ( c = getopt( argc, argv, "hm:r:g:" ) ) != -1 )
+   {
+      switch ( c )
+      {
+         case 'm': mb   = atoi( optarg ); break;
+         case 'r': reps = atoi( optarg ); break;
+         case 'g': ahead = ( size_t )atol( optarg ) << 10; break;
+         case 'h':
+            usage( argv[ 0 ] );
+            exit( EXIT_SUCCESS );
+         default:
+            usage( argv[ 0 ] );
+            exit( EXIT_FAILURE );
+      }
+   }
+
+   /* mem_sbrk takes an int, so the heap must be grown in one call below 2 GB */
+   if ( mb < 1 || mb > 2047 || reps < 1 || reps > MAX_REPS )
+      app_error( "membench: invalid parameters" );
+
+   heap_bytes = ( size_t )mb << 20;
+
+   bench_sbrk();
+   bench_touch();
+   bench_reset();
+   bench_thp();
+   bench_grow();
+   bench_vbuf();
+
+   return EXIT_SUCCESS;
+}
@@ -23,82 +23,1383 @@
  * except that it rejects requests to shrink the heap.
  *
  */
+#define _GNU_SOURCE                 // memfd_create, mremap, MREMAP_MAYMOVE
+
 #include "memlib.h"
 #include "std_wrappers.h"
 
-#include <errno.h>          // ENOMEM, errno
-#include <stdio.h>          // fprintf, stderr
-#include <stdlib.h>         // free
+#include <errno.h>          // EINVAL, ENOMEM, errno
+#include <pthread.h>        // pthread_t, pthread_mutex_t, pthread_cond_t
+#include <stdio.h>          // fclose, fopen, fprintf, fscanf, stderr
+#include <limits.h>         // INT_MAX
+#include <stdint.h>         // uintptr_t
+#include <stdlib.h>         // free
+#include <string.h>         // memcpy
+
+#include <sys/mman.h>       // madvise, memfd_create, mincore, mremap, MADV_*, PROT_*, MAP_*
+#include <unistd.h>         // close, ftruncate, getpagesize, sysconf
+
+#if defined( __x86_64__ )
+#include <immintrin.h>      // _mm_stream_si128, _mm256_stream_si256, _mm_sfence
+#endif
+
+
+// =======================
+// Constants and Macros  
+// =======================
+
+#define MAX_HEAP ( 20 * ( 1 << 20 ) )      /* 20 MB */
+
+#define DEFAULT_HUGE_PAGE ( 2 * ( 1 << 20 ) ) /* used if sysfs does not say */
+#define THP_SIZE_FILE "/sys/kernel/mm/transparent_hugepage/hpage_pmd_size"
+#define PSI_FILE      "/proc/pressure/memory"
+
+#define PREFAULT_STEP ( 256 * 1024 ) /* bytes the pre-growth thread faults at a time */
+
+#define GROW_SHIFT     4           /* mem_grow adds heapsize >> shift: 1/16th...    */
+#define GROW_MAX_SHIFT 8           /* ...down to 1/256th after trims                */
+#define GROW_RECOVER   4           /* growths without a trim undoing one back-off   */
+#define GROW_MAX       ( 32 << 20 ) /* largest geometric step                      */
+
+#define MAX_RECLAIM    8           /* application reclaim callbacks */
+
+#define DEFAULT_LLC    ( 8 << 20 )  /* last level cache size if sysconf does not say */
+#define STREAM_FLOOR   256         /* least stream_min: a head of up to 31 bytes and */
+                                   /* whole 128 byte rounds must fit in the copy      */
+
+#define MAX_REGIONS    128         /* subregions of the partitioned layout */
+
+#define ALIGN_UP( x, a )  ( ( ( uintptr_t )( x ) + ( a ) - 1 ) & ~( ( uintptr_t )( a ) - 1 ) )
+
+
+// ==========================
+// Private Global Variables
+// ==========================
+
+static char* mem_heap;     /* Points to first byte of heap          */
+static char* mem_brk;      /* Points to last byte of heap plus 1    */
+static char* mem_max_addr; /* Max legal heap addr plus 1            */
+
+static unsigned char* mem_residency;  /* mincore vector, one byte per page */
+
+static char*        mem_map;       /* Start of the mapping holding the heap  */
+static size_t       mem_map_len;   /* Length of that mapping                 */
+static mem_config_t mem_config;    /* Settings the heap was created with     */
+static int          mem_fd = -1;   /* memfd backing the heap, or -1          */
+static uint32_t*    page_file;     /* memfd page behind each heap page       */
+
+static mem_growth_t growth;        /* Counters reported by mem_growth()      */
+static int          grow_shift;    /* Current mem_grow step: heapsize >> shift */
+static int          grow_streak;   /* mem_grow calls since the last back-off   */
+
+static void         ( *purge_hook )( void );        /* allocator purge, or NULL */
+static mem_reclaim_fn reclaim_fns[ MAX_RECLAIM ];   /* application callbacks    */
+static void*        reclaim_args[ MAX_RECLAIM ];
+static int          nreclaim;
+static int          reclaiming;    /* inside the reclaim callbacks            */
+
+/* Partitioned layout: nregions subregions of region_span bytes, each with a brk */
+static char*  region_map;                    /* reservation holding the regions    */
+static size_t region_map_len;
+static char*  region_base;                   /* first region, aligned to its span  */
+static size_t region_span;
+static int    nregions;
+static char*  region_brk[ MAX_REGIONS ];
+static char*  region_touched[ MAX_REGIONS ]; /* highest brk since the reservation  */
+static size_t region_bytes;                  /* sum of the region sizes            */
+
+/* Blocks in mappings of their own, unordered */
+typedef struct
+{
+   char*  addr;
+   size_t len;
+} mem_block_t;
+
+static mem_block_t* blocks;
+static int          nblocks;
+static int          blocks_cap;
+static size_t       block_bytes;                   /* sum of the block lengths */
+
+/* Pre-growth thread; the variables below are protected by grow_lock */
+static pthread_t       grow_thread;
+static pthread_mutex_t grow_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  grow_cond = PTHREAD_COND_INITIALIZER;
+static char*           grow_faulted;   /* pages below this are pre-faulted         */
+static char*           grow_target;    /* the thread pre-faults up to here         */
+static unsigned        grow_gen;       /* bumped when pre-faulted pages are released */
+static int             grow_stop;
+
+
+// ==========================
+// Private Helper Functions
+// ==========================
+
+static char* clamp_to_heap( char* p )
+{
+   return p > mem_max_addr ? mem_max_addr : p;
+}
+
+
+/*
+ * mem_release - give the pages in [lo, hi) back to the kernel
+ *
+ * Only whole pages are released; their contents read as zero afterwards.
+ */
+static void mem_release( char* lo, char* hi )
+{
+   uintptr_t pagesize = mem_pagesize();
+   uintptr_t start    = ALIGN_UP( lo, pagesize );
+   uintptr_t end      = ( uintptr_t )hi & ~( pagesize - 1 );
+
+   /* MADV_DONTNEED only unmaps shared pages; MADV_REMOVE frees the memfd's */
+   if ( end > start && madvise( ( void* )start, end - start, mem_fd >= 0 ? MADV_REMOVE : MADV_DONTNEED ) < 0 )
+      unix_error( "mem_release: madvise error" );
+}
+
+
+/*
+ * mem_populate - take the write faults of the pages covering [lo, hi) now
+ *
+ * Page contents are left alone, so this is safe on pages the allocator
+ * is using at the same time.
+ */
+static void mem_populate( char* lo, char* hi )
+{
+   uintptr_t pagesize = mem_pagesize();
+   uintptr_t start    = ( uintptr_t )lo & ~( pagesize - 1 );
+   uintptr_t end      = ALIGN_UP( hi, pagesize );
+   uintptr_t p;
+
+   if ( end <= start )
+      return;
+
+#ifdef MADV_POPULATE_WRITE
+   if ( madvise( ( void* )start, end - start, MADV_POPULATE_WRITE ) == 0 )
+      return;
+   if ( errno != EINVAL )
+      unix_error( "mem_populate: madvise error" );
+#endif
+
+   /* Kernels before 5.14: an atomic add of zero writes without changing a byte */
+   for ( p = start; p < end; p += pagesize )
+      __atomic_fetch_add( ( char* )p, 0, __ATOMIC_RELAXED );
+}
+
+
+/*
+ * grow_main - pre-growth thread: keeps [mem_brk, mem_brk + prefault_ahead) faulted in
+ */
+static void* grow_main( void* arg )
+{
+   ( void )arg;
+
+   pthread_mutex_lock( &grow_lock );
+
+   for ( ;; )
+   {
+      char*    lo;
+      char*    hi;
+      unsigned gen;
+
+      while ( !grow_stop && grow_faulted >= grow_target )
+         pthread_cond_wait( &grow_cond, &grow_lock );
+
+      if ( grow_stop )
+         break;
+
+      lo  = grow_faulted;
+      hi  = lo + PREFAULT_STEP < grow_target ? lo + PREFAULT_STEP : grow_target;
+      gen = grow_gen;
+
+      pthread_mutex_unlock( &grow_lock );
+      mem_populate( lo, hi );
+      pthread_mutex_lock( &grow_lock );
+
+      if ( gen == grow_gen )
+         grow_faulted = hi;
+   }
+
+   pthread_mutex_unlock( &grow_lock );
+   return NULL;
+}
+
+
+/*
+ * discard_prefault - forget pre-faulted pages above lo, which are about to be released
+ *
+ * Return: the end of the pre-faulted pages, if it is above lo, or lo
+ */
+static char* discard_prefault( char* lo )
+{
+   char* hi = lo;
+
+   pthread_mutex_lock( &grow_lock );
+   if ( grow_faulted > lo )
+   {
+      hi           = grow_faulted;
+      grow_faulted = lo;
+      ++grow_gen;
+   }
+   if ( grow_target > lo )
+      grow_target = lo;
+   pthread_mutex_unlock( &grow_lock );
+
+   return hi;
+}
+
+
+/*
+ * reset_growth - start the growth policy and its counters over
+ */
+static void reset_growth( void )
+{
+   growth.grow_calls  = 0;
+   growth.trim_calls  = 0;
+   growth.requested   = 0;
+   growth.grown       = 0;
+   growth.trimmed     = 0;
+   growth.peak_heap   = mem_footprint();
+   growth.cold        = 0;
+   growth.paged_out   = 0;
+   growth.limit_hits  = 0;
+   growth.limit_fails = 0;
+   growth.copied      = 0;
+   growth.streamed    = 0;
+   growth.remaps      = 0;
+   growth.remapped    = 0;
+   growth.moved       = 0;
+   grow_shift         = GROW_SHIFT;
+   grow_streak        = 0;
+}
+
+
+/*
+ * note_peak - record the footprint if it is the largest so far
+ */
+static void note_peak( void )
+{
+   if ( mem_footprint() > growth.peak_heap )
+      growth.peak_heap = mem_footprint();
+}
+
+
+/*
+ * over_limit - bytes by which a footprint grown by incr would exceed its limit
+ */
+static size_t over_limit( size_t incr )
+{
+   size_t limit = mem_max_addr - mem_heap;
+   size_t size  = mem_footprint() + incr;
+
+   if ( mem_config.soft_limit > 0 && mem_config.soft_limit < limit )
+      limit = mem_config.soft_limit;
+
+   return size > limit ? size - limit : 0;
+}
+
+
+/*
+ * reclaim - make room for incr bytes: purge the allocator, then ask the
+ *           application, stopping as soon as the request fits
+ *
+ * Allocator calls made by the callbacks may grow the heap themselves;
+ * those are not reclaimed for again.
+ *
+ * Return: 1 if the heap can now grow by incr bytes, 0 otherwise
+ */
+static int reclaim( size_t incr )
+{
+   int i;
+
+   if ( reclaiming )
+      return 0;
+
+   reclaiming = 1;
+   ++growth.limit_hits;
+
+   if ( purge_hook != NULL )
+      purge_hook();
+
+   for ( i = 0; i < nreclaim && over_limit( incr ) > 0; ++i )
+      reclaim_fns[ i ]( over_limit( incr ), reclaim_args[ i ] );
+
+   reclaiming = 0;
+
+   if ( over_limit( incr ) > 0 )
+   {
+      ++growth.limit_fails;
+      return 0;
+   }
+
+   return 1;
+}
+
+
+/*
+ * grow_ahead - move the pre-growth target to prefault_ahead bytes above mem_brk
+ */
+static void grow_ahead( void )
+{
+   char* target = clamp_to_heap( mem_brk + mem_config.prefault_ahead );
+
+   pthread_mutex_lock( &grow_lock );
+   if ( target > grow_target )
+   {
+      grow_target = target;
+      pthread_cond_signal( &grow_cond );
+   }
+   pthread_mutex_unlock( &grow_lock );
+}
+
+
+/*
+ * reset_regions - empty every region and, if configured, release its pages
+ */
+static void reset_regions( void )
+{
+   int r;
+
+   for ( r = 0; r < nregions; ++r )
+   {
+      char* lo = region_base + r * region_span;
+
+      if ( mem_config.release_pages )
+      {
+         mem_release( lo, ( char* )ALIGN_UP( region_touched[ r ], mem_pagesize() ) );
+         region_touched[ r ] = lo;
+      }
+      region_brk[ r ] = lo;
+   }
+
+   region_bytes = 0;
+}
+
+
+/*
+ * find_block - index of the mapped block at addr, or -1
+ */
+static int find_block( const char* addr )
+{
+   int i;
+
+   for ( i = nblocks - 1; i >= 0; --i )
+   {
+      if ( blocks[ i ].addr == addr )
+         return i;
+   }
+
+   return -1;
+}
+
+
+/*
+ * unmap_blocks - unmap every mapped block
+ */
+static void unmap_blocks( void )
+{
+   int i;
+
+   for ( i = 0; i < nblocks; ++i )
+      Munmap( blocks[ i ].addr, blocks[ i ].len );
+
+   nblocks     = 0;
+   block_bytes = 0;
+}
+
+
+/*
+ * count_resident - bytes of the pages covering [lo, hi) that are resident
+ *
+ * mincore fills mem_residency, which holds the pages of max_heap bytes,
+ * so larger ranges are counted a piece at a time.
+ */
+static size_t count_resident( char* lo, char* hi )
+{
+   uintptr_t pagesize = mem_pagesize();
+   uintptr_t start    = ( uintptr_t )lo & ~( pagesize - 1 );
+   uintptr_t end      = ALIGN_UP( hi, pagesize );
+   size_t    chunk    = mem_config.max_heap / pagesize;
+   size_t    resident = 0;
+
+   while ( start < end )
+   {
+      size_t npages = ( end - start ) / pagesize;
+      size_t i;
+
+      if ( npages > chunk )
+         npages = chunk;
+
+      if ( mincore( ( void* )start, npages * pagesize, mem_residency ) < 0 )
+         unix_error( "mem_resident: mincore error" );
+
+      for ( i = 0; i < npages; ++i )
+         resident += mem_residency[ i ] & 0x1;
+
+      start += npages * pagesize;
+   }
+
+   return resident * pagesize;
+}
+
+
+/*
+ * stream_copy - copy n bytes with non-temporal stores, which bypass the
+ *               cache, so the destination does not evict the working set
+ *
+ * The head up to the first vector boundary of dst and the tail are copied
+ * with memcpy; the stores are ordered with sfence before returning. n must
+ * be at least STREAM_FLOOR, which mem_stream_threshold guarantees.
+ */
+static void stream_copy( char* dst, const char* src, size_t n )
+{
+#if defined( __AVX2__ )
+   size_t head = -( uintptr_t )dst & 31;
+
+   memcpy( dst, src, head );
+   dst += head;
+   src += head;
+   n   -= head;
+
+   for ( ; n >= 128; n -= 128, dst += 128, src += 128 )
+   {
+      __m256i a = _mm256_loadu_si256( ( const __m256i* )src );
+      __m256i b = _mm256_loadu_si256( ( const __m256i* )( src + 32 ) );
+      __m256i c = _mm256_loadu_si256( ( const __m256i* )( src + 64 ) );
+      __m256i d = _mm256_loadu_si256( ( const __m256i* )( src + 96 ) );
+
+      _mm256_stream_si256( ( __m256i* )dst, a );
+      _mm256_stream_si256( ( __m256i* )( dst + 32 ), b );
+      _mm256_stream_si256( ( __m256i* )( dst + 64 ), c );
+      _mm256_stream_si256( ( __m256i* )( dst + 96 ), d );
+   }
+   _mm_sfence();
+#elif defined( __x86_64__ )
+   size_t head = -( uintptr_t )dst & 15;
+
+   memcpy( dst, src, head );
+   dst += head;
+   src += head;
+   n   -= head;
+
+   for ( ; n >= 64; n -= 64, dst += 64, src += 64 )
+   {
+      __m128i a = _mm_loadu_si128( ( const __m128i* )src );
+      __m128i b = _mm_loadu_si128( ( const __m128i* )( src + 16 ) );
+      __m128i c = _mm_loadu_si128( ( const __m128i* )( src + 32 ) );
+      __m128i d = _mm_loadu_si128( ( const __m128i* )( src + 48 ) );
+
+      _mm_stream_si128( ( __m128i* )dst, a );
+      _mm_stream_si128( ( __m128i* )( dst + 16 ), b );
+      _mm_stream_si128( ( __m128i* )( dst + 32 ), c );
+      _mm_stream_si128( ( __m128i* )( dst + 48 ), d );
+   }
+   _mm_sfence();
+#endif
+
+   memcpy( dst, src, n );
+}
+
+
+/*
+ * map_heap - create the mapping holding the heap and set mem_heap
+ *
+ * The heap starts at config->base_addr if one is given, and otherwise on
+ * the first boundary of the alignment within a mapping one alignment unit
+ * larger than the heap.
+ */
+static void map_heap( const mem_config_t* config )
+{
+   size_t align = ( config->huge_pages == MEM_THP_ALWAYS ) ? mem_hugepagesize() : mem_pagesize();
+   int    flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+   if ( config->align > align )
+      align = config->align;
+   if ( ( align & ( align - 1 ) ) != 0 )
+      app_error( "mem_init: heap alignment must be a power of two" );
+
+   if ( config->prefault == MEM_PREFAULT_ALL )
+      flags |= MAP_POPULATE;
+
+   if ( config->base_addr == NULL )
+   {
+      mem_map_len = config->max_heap + align;
+      mem_map     = ( char* )Mmap( NULL, mem_map_len, PROT_READ | PROT_WRITE, flags, -1, 0 );
+      mem_heap    = ( char* )ALIGN_UP( mem_map, align );
+      return;
+   }
+
+   if ( ( uintptr_t )config->base_addr % align != 0 )
+      app_error( "mem_init: heap base address is not aligned" );
+
+   /* Without MAP_FIXED_NOREPLACE the address is only a hint; never replace
+      an existing mapping with MAP_FIXED */
+#ifdef MAP_FIXED_NOREPLACE
+   flags |= MAP_FIXED_NOREPLACE;
+#endif
+
+   mem_map_len = config->max_heap;
+   mem_map     = ( char* )mmap( config->base_addr, mem_map_len, PROT_READ | PROT_WRITE, flags, -1, 0 );
+
+   if ( mem_map == ( char* )MAP_FAILED )
+      unix_error( "mem_init: cannot map the heap at its base address" );
+
+   if ( mem_map != ( char* )config->base_addr )
+   {
+      Munmap( mem_map, mem_map_len );
+      app_error( "mem_init: heap base address is not available" );
+   }
+
+   mem_heap = mem_map;
+}
+
+
+/*
+ * map_memfd - back the heap with a memfd, mapped shared over the heap's
+ *             part of the reservation, heap page i on memfd page i
+ */
+static void map_memfd( const mem_config_t* config )
+{
+   size_t pages = config->max_heap / mem_pagesize();
+   size_t i;
+   int    flags = MAP_SHARED | MAP_FIXED;
+
+   if ( ( mem_fd = memfd_create( "memlib", MFD_CLOEXEC ) ) < 0 )
+      unix_error( "mem_init: memfd_create error" );
+
+   if ( ftruncate( mem_fd, config->max_heap ) < 0 )
+      unix_error( "mem_init: ftruncate error" );
+
+   if ( config->prefault == MEM_PREFAULT_ALL )
+      flags |= MAP_POPULATE;
+
+   Mmap( mem_heap, config->max_heap, PROT_READ | PROT_WRITE, flags, mem_fd, 0 );
+
+   page_file = ( uint32_t* )Malloc( pages * sizeof( uint32_t ) );
+   for ( i = 0; i < pages; ++i )
+      page_file[ i ] = ( uint32_t )i;
+}
+
+
+/*
+ * map_pages - map heap pages [first, first + n) onto their memfd pages,
+ *             one mmap per run of consecutive memfd pages; the pages are
+ *             populated at once rather than faulted in one by one later
+ */
+static void map_pages( size_t first, size_t n )
+{
+   size_t page = mem_pagesize();
+   size_t end  = first + n;
+   size_t run;
+
+   for ( ; first < end; first += run )
+   {
+      for ( run = 1; first + run < end && page_file[ first + run ] == page_file[ first ] + run; ++run )
+         ;
+
+      Mmap( mem_heap + first * page, run * page, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED | MAP_POPULATE,
+            mem_fd, ( long )page_file[ first ] * page );
+   }
+}
+
+
+// ==========================
+// Public Functions
+// ==========================
+
+/*
+ * mem_config_default - fill in the settings mem_init() uses
+ */
+void mem_config_default( mem_config_t* config )
+{
+   config->max_heap       = MAX_HEAP;
+   config->release_pages  = 0;
+   config->huge_pages     = MEM_THP_DEFAULT;
+   config->prefault       = MEM_PREFAULT_NONE;
+   config->prefault_ahead = 0;
+   config->base_addr      = NULL;
+   config->align          = 0;
+   config->soft_limit     = 0;
+   config->stream_min     = 0;
+   config->memfd          = 0;
+}
+
+
+/**
+ * mem_init_config - Initialize the memory system model with the given settings
+ *
+ * The heap is a private anonymous mapping of its own, so its pages are
+ * untouched until the allocator writes them and mem_resident() measures
+ * the heap alone. For MEM_THP_ALWAYS the heap starts on a huge page
+ * boundary, which the kernel needs to back it with huge pages.
+ *
+ * With a base_addr the heap is placed at that address, so that its layout,
+ * and with it cache set and TLB behaviour, is the same from run to run.
+ *
+ * With memfd set the heap is a shared mapping of a memfd instead, so that
+ * mem_move_pages() can move pages by mapping them elsewhere.
+ *
+ * With a prefault_ahead the pre-growth thread is started; it runs until
+ * mem_deinit().
+ */
+void mem_init_config( const mem_config_t* config )
+{
+   mem_config = *config;
+   map_heap( config );
+
+   if ( config->memfd )
+      map_memfd( config );
+
+   mem_brk      = ( char* )mem_heap;
+   mem_max_addr = ( char* )( mem_heap + config->max_heap );
+
+   if ( config->huge_pages != MEM_THP_DEFAULT
+        && madvise( mem_heap, config->max_heap,
+                    config->huge_pages == MEM_THP_ALWAYS ? MADV_HUGEPAGE : MADV_NOHUGEPAGE ) < 0 )
+      unix_error( "mem_init: madvise error" );
+
+   mem_residency = ( unsigned char* )Malloc( config->max_heap / mem_pagesize() + 2 );
+   reset_growth();
+
+   if ( config->prefault_ahead > 0 )
+   {
+      grow_faulted = mem_heap;
+      grow_target  = mem_heap;
+      grow_stop    = 0;
+      Pthread_create( &grow_thread, NULL, grow_main, NULL );
+      grow_ahead();
+   }
+}
+
+
+/**
+ * mem_init - Initialize the memory system model with the default settings
+ *
+ */
+void mem_init( void )
+{
+   mem_config_t config;
+
+   mem_config_default( &config );
+   mem_init_config( &config );
+}
+
+
+/*
+ * mem_sbrk - Simple model of the sbrk function.
+ *            Extends the heap by incr bytes and returns the start address of the new area.
+ *            The heap only shrinks through mem_trim and mem_reset_brk.
+ *
+ * A request beyond the soft limit or the end of the heap first runs the
+ * purge hook and the reclaim callbacks.
+ *
+ * Return: On success, returns the previous program break.
+ *         On error, (void *) -1 is returned, and errno is set to ENOMEM
+ */
+void* mem_sbrk( int incr )
+{
+   char* old_brk;
+
+   if ( ( incr < 0 ) || ( over_limit( incr ) > 0 && !reclaim( incr ) ) )
+   {
+      errno = ENOMEM;
+      if ( incr >= 0 && mem_footprint() + incr <= mem_config.max_heap )
+         fprintf( stderr, "ERROR: mem_sbrk failed - Soft heap limit reached...\n" );
+      else
+         fprintf( stderr, "ERROR: mem_sbrk failed - Ran out of memory...\n" );
+      return ( void* )-1;
+   }
+
+   /* Reclaiming may have moved the brk */
+   old_brk  = mem_brk;
+   mem_brk += incr;
+   note_peak();
+
+   if ( mem_config.prefault == MEM_PREFAULT_SBRK )
+      mem_populate( old_brk, mem_brk );
+   if ( mem_config.prefault_ahead > 0 )
+      grow_ahead();
+
+   return ( void* )old_brk;
+}
+
+
+/*
+ * mem_grow_size - bytes mem_grow would extend the heap by for a need of need bytes
+ *
+ * The step is the larger of need and heapsize >> grow_shift (capped at
+ * GROW_MAX), rounded up so that the new brk is page aligned, or huge
+ * page aligned once the step is at least a huge page and huge pages are
+ * not disabled. Near the end of the heap or the soft limit the step falls
+ * back to need; mem_sbrk reclaims memory if even that does not fit.
+ *
+ * Return: the step, or 0 if need is too large for mem_sbrk
+ */
+size_t mem_grow_size( size_t need )
+{
+   size_t    step = mem_heapsize() >> grow_shift;
+   size_t    unit = mem_pagesize();
+   uintptr_t end;
+
+   if ( need > INT_MAX )
+      return 0;
+
+   if ( step > GROW_MAX )
+      step = GROW_MAX;
+   if ( step < need )
+      step = need;
+
+   if ( step >= mem_hugepagesize() && mem_config.huge_pages != MEM_THP_NEVER )
+      unit = mem_hugepagesize();
+
+   end = ALIGN_UP( mem_brk + step, unit );
+   if ( end - ( uintptr_t )mem_brk > INT_MAX || over_limit( end - ( uintptr_t )mem_brk ) > 0 )
+      return need;
+
+   return end - ( uintptr_t )mem_brk;
+}
+
+
+/*
+ * mem_grow - extend the heap by at least need bytes, as mem_grow_size chooses
+ *
+ * Return: the previous brk, with the bytes added in *got, or (void *) -1
+ *         with errno set to ENOMEM
+ */
+void* mem_grow( size_t need, size_t* got )
+{
+   size_t step = mem_grow_size( need );
+   void*  p;
+
+   if ( step == 0 )
+   {
+      errno = ENOMEM;
+      return ( void* )-1;
+   }
+
+   if ( ( p = mem_sbrk( ( int )step ) ) == ( void* )-1 )
+      return p;
+
+   ++growth.grow_calls;
+   growth.requested += need;
+   growth.grown     += step;
+
+   /* Recover from a back-off after a run of growths without trims */
+   if ( grow_shift > GROW_SHIFT && ++grow_streak >= GROW_RECOVER )
+   {
+      --grow_shift;
+      grow_streak = 0;
+   }
+
+   *got = step;
+   return p;
+}
+
+
+/*
+ * mem_trim - shrink the heap by bytes and, if configured, give the pages
+ *            above the new brk back
+ *
+ * Every trim halves the steps of the following mem_grow calls, down to
+ * heapsize >> GROW_MAX_SHIFT.
+ *
+ * Return: 0 on success, -1 if bytes exceeds the heap size
+ */
+int mem_trim( size_t bytes )
+{
+   char* hi = ( char* )ALIGN_UP( mem_brk, mem_pagesize() );
+
+   if ( bytes > mem_heapsize() )
+      return -1;
+
+   mem_brk -= bytes;
+
+   if ( mem_config.release_pages )
+   {
+      if ( mem_config.prefault_ahead > 0 )
+      {
+         char* faulted = discard_prefault( mem_brk );
+
+         if ( faulted > hi )
+            hi = faulted;
+      }
+
+      mem_release( mem_brk, hi );
+   }
+
+   ++growth.trim_calls;
+   growth.trimmed += bytes;
+   if ( grow_shift < GROW_MAX_SHIFT )
+      ++grow_shift;
+   grow_streak = 0;
+
+   if ( mem_config.prefault_ahead > 0 )
+      grow_ahead();
+
+   return 0;
+}
+
+
+/*
+ * mem_growth - copy the growth counters
+ */
+void mem_growth( mem_growth_t* stats )
+{
+   *stats = growth;
+}
+
 
-#include <unistd.h>         // getpagesize
+/*
+ * mem_advise_cold - hint that the whole pages inside [lo, hi) are idle
+ *
+ * The pages keep their contents. MADV_COLD moves them to the inactive list,
+ * so reclaim takes them first; with pageout set, MADV_PAGEOUT reclaims them
+ * now. Kernels before 5.4 know neither, and the hint is dropped.
+ *
+ * Return: the number of bytes hinted
+ */
+size_t mem_advise_cold( void* lo, void* hi, int pageout )
+{
+   uintptr_t pagesize = mem_pagesize();
+   uintptr_t start    = ALIGN_UP( lo, pagesize );
+   uintptr_t end      = ( uintptr_t )hi & ~( pagesize - 1 );
 
+   if ( end <= start )
+      return 0;
 
-// =======================
-// Constants and Macros  
-// =======================
+#if defined( MADV_COLD ) && defined( MADV_PAGEOUT )
+   if ( madvise( ( void* )start, end - start, pageout ? MADV_PAGEOUT : MADV_COLD ) < 0 )
+   {
+      if ( errno != EINVAL )
+         unix_error( "mem_advise_cold: madvise error" );
+      return 0;
+   }
 
-#define MAX_HEAP ( 20 * ( 1 << 20 ) )      /* 20 MB */
+   if ( pageout )
+      growth.paged_out += end - start;
+   else
+      growth.cold += end - start;
 
+   return end - start;
+#else
+   ( void )pageout;
+   return 0;
+#endif
+}
 
-// ==========================
-// Private Global Variables
-// ==========================
 
-static char* mem_heap;     /* Points to first byte of heap          */
-static char* mem_brk;      /* Points to last byte of heap plus 1    */
-static char* mem_max_addr; /* Max legal heap addr plus 1            */
+/*
+ * mem_pressure - share of time, in percent over the last 10 seconds, that
+ *                some task stalled on memory; 0 if the kernel does not say
+ */
+double mem_pressure( void )
+{
+   double avg10 = 0.0;
+   FILE*  fp;
 
+   if ( ( fp = fopen( PSI_FILE, "r" ) ) == NULL )
+      return 0.0;
 
-/**
- * mem_init - Initialize the memory system model
+   if ( fscanf( fp, "some avg10=%lf", &avg10 ) != 1 )
+      avg10 = 0.0;
+   fclose( fp );
+
+   return avg10;
+}
+
+
+/*
+ * mem_set_purge - set the allocator's hook for emptying its caches and trimming
+ *                 the heap when the heap limit is reached; NULL for none
+ */
+void mem_set_purge( void ( *purge )( void ) )
+{
+   purge_hook = purge;
+}
+
+
+/*
+ * mem_add_reclaim - register an application callback for when the heap limit
+ *                   is reached, after the allocator's purge hook
  *
+ * Return: 0 on success, -1 if MAX_RECLAIM callbacks are registered already
  */
-void mem_init( void )
+int mem_add_reclaim( mem_reclaim_fn fn, void* arg )
 {
-   mem_heap     = ( char* )Malloc( MAX_HEAP );
-   mem_brk      = ( char* )mem_heap;
-   mem_max_addr = ( char* )( mem_heap + MAX_HEAP );
+   if ( nreclaim == MAX_RECLAIM )
+      return -1;
+
+   reclaim_fns[ nreclaim ]  = fn;
+   reclaim_args[ nreclaim ] = arg;
+   ++nreclaim;
+   return 0;
 }
 
 
 /*
- * mem_sbrk - Simple model of the sbrk function.
- *            Extends the heap by incr bytes and returns the start address of the new area.
- *            In this model, the heap cannot be shrunk.
+ * mem_stream_threshold - size from which mem_copy streams: stream_min, but
+ *                        at least STREAM_FLOOR, or half the last level
+ *                        cache if stream_min is 0
+ */
+size_t mem_stream_threshold( void )
+{
+   static size_t llc = 0;
+
+   if ( mem_config.stream_min > 0 )
+      return mem_config.stream_min < STREAM_FLOOR ? STREAM_FLOOR : mem_config.stream_min;
+
+   if ( llc == 0 )
+   {
+      long size = sysconf( _SC_LEVEL3_CACHE_SIZE );
+
+      if ( size <= 0 )
+         size = sysconf( _SC_LEVEL2_CACHE_SIZE );
+      llc = size > 0 ? ( size_t )size : DEFAULT_LLC;
+   }
+
+   return llc / 2;
+}
+
+
+/*
+ * mem_copy - copy a block of n bytes that an allocator moves, as realloc does
  *
- * Return: On success, returns the previous program break.
- *         On error, (void *) -1 is returned, and errno is set to ENOMEM
+ * Copies below mem_stream_threshold() use memcpy, which the C library
+ * vectorizes for the machine it runs on. Larger ones would push most of
+ * the cache out for data that is not read again soon, and use
+ * non-temporal stores instead. Both count toward the copy counters.
  */
-void* mem_sbrk( int incr )
+void mem_copy( void* dst, const void* src, size_t n )
+{
+   growth.copied += n;
+
+   if ( n < mem_stream_threshold() )
+   {
+      memcpy( dst, src, n );
+      return;
+   }
+
+   growth.streamed += n;
+   stream_copy( ( char* )dst, ( const char* )src, n );
+}
+
+
+/*
+ * mem_pages_movable - whether mem_move_pages can move heap pages, that is
+ *                     whether the heap is backed by a memfd
+ */
+int mem_pages_movable( void )
+{
+   return mem_fd >= 0;
+}
+
+
+/*
+ * mem_move_pages - move the len bytes at src to dst by remapping pages
+ *
+ * dst, src and len must be page aligned and the two ranges must lie below
+ * the brk without overlapping. The memfd pages behind src are mapped at
+ * dst, and those that were behind dst at src, so every heap page keeps a
+ * page of its own; src reads as dst did before.
+ *
+ * Return: 0 on success, -1 with errno set to ENOTSUP without a memfd or
+ *         EINVAL for bad ranges
+ */
+int mem_move_pages( void* dst, void* src, size_t len )
+{
+   size_t page = mem_pagesize();
+   size_t d    = ( size_t )( ( char* )dst - mem_heap ) / page;
+   size_t s    = ( size_t )( ( char* )src - mem_heap ) / page;
+   size_t n    = len / page;
+   size_t i;
+
+   if ( mem_fd < 0 )
+   {
+      errno = ENOTSUP;
+      return -1;
+   }
+
+   if ( ( ( uintptr_t )dst | ( uintptr_t )src | len ) & ( page - 1 )
+        || ( char* )dst < mem_heap || ( char* )src < mem_heap
+        || ( char* )dst + len > mem_brk || ( char* )src + len > mem_brk
+        || ( d < s + n && s < d + n ) )
+   {
+      errno = EINVAL;
+      return -1;
+   }
+
+   for ( i = 0; i < n; ++i )
+   {
+      uint32_t f = page_file[ d + i ];
+
+      page_file[ d + i ] = page_file[ s + i ];
+      page_file[ s + i ] = f;
+   }
+
+   map_pages( d, n );
+   map_pages( s, n );
+   growth.moved += len;
+
+   return 0;
+}
+
+
+/*
+ * mem_map_block - map len bytes, rounded up to pages, for a single block
+ *
+ * Blocks too large for the heap get a mapping of their own, so that they
+ * can be resized with mem_remap_block and given back whole. They count
+ * against the heap limits like the heap itself.
+ *
+ * Return: the start of the mapping, or NULL with errno set
+ */
+void* mem_map_block( size_t len )
+{
+   char* p;
+
+   len = ALIGN_UP( len, mem_pagesize() );
+
+   if ( over_limit( len ) > 0 && !reclaim( len ) )
+   {
+      errno = ENOMEM;
+      return NULL;
+   }
+
+   p = ( char* )mmap( NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+   if ( p == ( char* )MAP_FAILED )
+      return NULL;
+
+   if ( nblocks == blocks_cap )
+   {
+      blocks_cap = blocks_cap ? 2 * blocks_cap : 16;
+      blocks     = ( mem_block_t* )Realloc( blocks, blocks_cap * sizeof( mem_block_t ) );
+   }
+
+   blocks[ nblocks ].addr = p;
+   blocks[ nblocks ].len  = len;
+   ++nblocks;
+   block_bytes += len;
+   note_peak();
+
+   return p;
+}
+
+
+/*
+ * mem_remap_block - resize the mapped block at p to len bytes, rounded up
+ *                   to pages, with mremap( MREMAP_MAYMOVE )
+ *
+ * The kernel moves the page table entries, not the bytes, so resizing
+ * costs time in proportion to the pages, and the contents are kept.
+ *
+ * Return: the possibly moved block, or NULL with errno set and the block
+ *         left as it was
+ */
+void* mem_remap_block( void* p, size_t len )
+{
+   int   i = find_block( ( char* )p );
+   char* q;
+
+   len = ALIGN_UP( len, mem_pagesize() );
+
+   if ( i < 0 )
+   {
+      errno = EINVAL;
+      return NULL;
+   }
+
+   if ( len > blocks[ i ].len && over_limit( len - blocks[ i ].len ) > 0
+        && ( !reclaim( len - blocks[ i ].len ) || ( i = find_block( ( char* )p ) ) < 0 ) )
+   {
+      errno = ENOMEM;
+      return NULL;
+   }
+
+   if ( len == blocks[ i ].len )
+      return p;
+
+   q = ( char* )mremap( p, blocks[ i ].len, len, MREMAP_MAYMOVE );
+   if ( q == ( char* )MAP_FAILED )
+      return NULL;
+
+   ++growth.remaps;
+   growth.remapped += blocks[ i ].len < len ? blocks[ i ].len : len;
+
+   block_bytes     += len;
+   block_bytes     -= blocks[ i ].len;
+   blocks[ i ].addr = q;
+   blocks[ i ].len  = len;
+   note_peak();
+
+   return q;
+}
+
+
+/*
+ * mem_unmap_block - give the mapped block at p back to the kernel
+ */
+void mem_unmap_block( void* p )
+{
+   int i = find_block( ( char* )p );
+
+   if ( i < 0 )
+      app_error( "mem_unmap_block: not a mapped block" );
+
+   Munmap( blocks[ i ].addr, blocks[ i ].len );
+   block_bytes -= blocks[ i ].len;
+   blocks[ i ]  = blocks[ --nblocks ];
+}
+
+
+/*
+ * mem_regions_init - reserve n regions of span bytes each, next to the heap
+ *
+ * The reservation is aligned to span, a power of two, so the region of an
+ * address is ( addr - mem_region_lo( 0 ) ) / span. A span of 0 picks the
+ * smallest power of two that holds max_heap, so that any one region can
+ * take the whole heap. The regions are reserved once and kept for later
+ * calls with the same layout; every call leaves them empty.
+ *
+ * Return: 0 on success, -1 with errno set on a bad layout or a failed mmap
+ */
+int mem_regions_init( int n, size_t span )
+{
+   int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+   int r;
+
+   if ( span == 0 )
+      for ( span = mem_pagesize(); span < mem_config.max_heap; span <<= 1 )
+         ;
+
+   if ( n < 1 || n > MAX_REGIONS || span < mem_pagesize() || ( span & ( span - 1 ) ) != 0 )
+   {
+      errno = EINVAL;
+      return -1;
+   }
+
+   if ( region_map != NULL && n == nregions && span == region_span )
+   {
+      reset_regions();
+      return 0;
+   }
+
+   if ( region_map != NULL )
+   {
+      Munmap( region_map, region_map_len );
+      region_map = NULL;
+      nregions   = 0;
+   }
+
+   region_map_len = ( size_t )n * span + span;
+   region_map     = ( char* )mmap( NULL, region_map_len, PROT_READ | PROT_WRITE, flags, -1, 0 );
+   if ( region_map == ( char* )MAP_FAILED )
+   {
+      region_map = NULL;
+      return -1;
+   }
+
+   if ( mem_config.huge_pages != MEM_THP_DEFAULT
+        && madvise( region_map, region_map_len,
+                    mem_config.huge_pages == MEM_THP_ALWAYS ? MADV_HUGEPAGE : MADV_NOHUGEPAGE ) < 0 )
+      unix_error( "mem_regions_init: madvise error" );
+
+   region_base = ( char* )ALIGN_UP( region_map, span );
+   region_span = span;
+   nregions    = n;
+
+   for ( r = 0; r < n; ++r )
+   {
+      region_brk[ r ]     = region_base + r * span;
+      region_touched[ r ] = region_brk[ r ];
+   }
+   region_bytes = 0;
+
+   return 0;
+}
+
+
+/*
+ * mem_region_sbrk - extend region r by incr bytes
+ *
+ * Regions grow independently of each other and of the heap, but count
+ * against the same limits: past them the purge hook and the reclaim
+ * callbacks run first, as for mem_sbrk.
+ *
+ * Return: the previous brk of the region, or (void *) -1 with errno set
+ */
+void* mem_region_sbrk( int r, size_t incr )
 {
-   char* old_brk = mem_brk;
+   char* old_brk;
+
+   if ( r < 0 || r >= nregions )
+   {
+      errno = EINVAL;
+      return ( void* )-1;
+   }
+
+   if ( incr > ( size_t )( region_base + ( r + 1 ) * region_span - region_brk[ r ] ) )
+   {
+      errno = ENOMEM;
+      fprintf( stderr, "ERROR: mem_region_sbrk failed - Region %d is full...\n", r );
+      return ( void* )-1;
+   }
 
-   if ( ( incr < 0 ) || ( mem_brk > ( mem_max_addr - incr ) ) )
+   if ( over_limit( incr ) > 0 && !reclaim( incr ) )
    {
       errno = ENOMEM;
-      fprintf( stderr, "ERROR: mem_sbrk failed - Ran out of memory...\n" );
+      if ( mem_footprint() + incr <= mem_config.max_heap )
+         fprintf( stderr, "ERROR: mem_region_sbrk failed - Soft heap limit reached...\n" );
+      else
+         fprintf( stderr, "ERROR: mem_region_sbrk failed - Ran out of memory...\n" );
       return ( void* )-1;
    }
 
+   old_brk          = region_brk[ r ];
+   region_brk[ r ] += incr;
+   region_bytes    += incr;
+   if ( region_brk[ r ] > region_touched[ r ] )
+      region_touched[ r ] = region_brk[ r ];
+   note_peak();
+
+   if ( mem_config.prefault == MEM_PREFAULT_SBRK )
+      mem_populate( old_brk, region_brk[ r ] );
+
    return ( void* )old_brk;
 }
 
 
+/*
+ * mem_region_lo - return address of the first byte of region r
+ */
+void* mem_region_lo( int r )
+{
+   return ( void* )( region_base + r * region_span );
+}
+
+
+/*
+ * mem_region_size - returns the size of region r in bytes
+ */
+size_t mem_region_size( int r )
+{
+   return region_brk[ r ] - ( region_base + r * region_span );
+}
+
+
+/*
+ * mem_region_span - returns the bytes reserved for each region
+ */
+size_t mem_region_span( void )
+{
+   return region_span;
+}
+
+
+/*
+ * mem_footprint - returns the heap size plus the sizes of all regions and
+ *                 mapped blocks
+ */
+size_t mem_footprint( void )
+{
+   return mem_heapsize() + region_bytes + block_bytes;
+}
+
+
+/*
+ * mem_in_heap - whether [p, p + size) lies inside the heap, inside the
+ *               used part of a single region or inside a mapped block
+ */
+int mem_in_heap( const void* p, size_t size )
+{
+   const char* lo = ( const char* )p;
+   size_t      r;
+   int         i;
+
+   if ( lo >= mem_heap && lo <= mem_brk && size <= ( size_t )( mem_brk - lo ) )
+      return 1;
+
+   for ( i = 0; i < nblocks; ++i )
+   {
+      if ( lo >= blocks[ i ].addr && lo <= blocks[ i ].addr + blocks[ i ].len
+           && size <= ( size_t )( blocks[ i ].addr + blocks[ i ].len - lo ) )
+         return 1;
+   }
+
+   if ( nregions == 0 || lo < region_base )
+      return 0;
+
+   r = ( lo - region_base ) / region_span;
+   return r < ( size_t )nregions && lo <= region_brk[ r ] && size <= ( size_t )( region_brk[ r ] - lo );
+}
+
+
 /*
  * mem_deinit - free the storage used by the memory system model
  */
 void mem_deinit( void )
 {
-   free( mem_heap );
+   if ( mem_config.prefault_ahead > 0 )
+   {
+      pthread_mutex_lock( &grow_lock );
+      grow_stop = 1;
+      pthread_cond_signal( &grow_cond );
+      pthread_mutex_unlock( &grow_lock );
+      Pthread_join( grow_thread, NULL );
+   }
+
+   if ( region_map != NULL )
+   {
+      Munmap( region_map, region_map_len );
+      region_map = NULL;
+      nregions   = 0;
+   }
+
+   unmap_blocks();
+   free( blocks );
+   blocks     = NULL;
+   blocks_cap = 0;
+
+   free( mem_residency );
+   Munmap( mem_map, mem_map_len );
+
+   if ( mem_fd >= 0 )
+   {
+      close( mem_fd );
+      mem_fd = -1;
+      free( page_file );
+      page_file = NULL;
+   }
 }
 
 
 /*
  * mem_reset_brk - reset the simulated brk pointer to make an empty heap
+ *                 and, if configured, release the pages the heap used
  */
 void mem_reset_brk()
 {
+   if ( mem_config.release_pages )
+   {
+      char* hi = ( char* )ALIGN_UP( mem_brk, mem_pagesize() );
+
+      /* Pre-faulted pages above the brk go too, and must be faulted again */
+      if ( mem_config.prefault_ahead > 0 )
+      {
+         char* faulted = discard_prefault( mem_heap );
+
+         if ( faulted > hi )
+            hi = faulted;
+      }
+
+      mem_release( mem_heap, hi );
+   }
+
    mem_brk = mem_heap;
+   reset_regions();
+   unmap_blocks();
+   reset_growth();
+
+   if ( mem_config.prefault_ahead > 0 )
+      grow_ahead();
 }
 
 
@@ -135,4 +1436,49 @@ size_t mem_heapsize()
 size_t mem_pagesize()
 {
    return getpagesize();
-}
\ No newline at end of file
+}
+
+
+/*
+ * mem_hugepagesize() - returns the transparent huge page size of the system
+ */
+size_t mem_hugepagesize()
+{
+   static size_t size = 0;
+   FILE*         fp;
+
+   if ( size != 0 )
+      return size;
+
+   size = DEFAULT_HUGE_PAGE;
+   if ( ( fp = fopen( THP_SIZE_FILE, "r" ) ) != NULL )
+   {
+      if ( fscanf( fp, "%zu", &size ) != 1 || size == 0 )
+         size = DEFAULT_HUGE_PAGE;
+      fclose( fp );
+   }
+
+   return size;
+}
+
+
+/*
+ * mem_resident() - returns the number of bytes of the heap region and the
+ *                  regions that are resident in physical memory, including
+ *                  pages above the current brk that were touched before a
+ *                  mem_reset_brk
+ */
+size_t mem_resident()
+{
+   size_t resident = count_resident( mem_heap, mem_max_addr );
+   int    r;
+   int    i;
+
+   for ( r = 0; r < nregions; ++r )
+      resident += count_resident( region_base + r * region_span, region_touched[ r ] );
+
+   for ( i = 0; i < nblocks; ++i )
+      resident += count_resident( blocks[ i ].addr, blocks[ i ].addr + blocks[ i ].len );
+
+   return resident;
+}
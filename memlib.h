@@ -12,14 +12,147 @@
  * 
  * Any application wishing to use the allocator must first call mem_init() to initialize 
  * the memory system.
+ *
+ * mem_init_config() initializes it with settings other than the defaults that
+ * mem_config_default() fills in: a different heap size, pages handed back to the
+ * kernel on mem_reset_brk(), a transparent huge page policy, or pages that are
+ * pre-faulted before the allocator writes them, so that growing the heap does
+ * not take page faults on the allocation path. For reproducible layouts the
+ * heap can be mapped at a fixed address (MAP_FIXED_NOREPLACE) and aligned.
+ *
+ * mem_advise_cold() lets an allocator tell the kernel that free memory
+ * inside the heap has gone idle, so that reclaim takes it before pages in
+ * use; mem_pressure() tells it whether to ask for the pages to be paged out
+ * right away.
+ *
+ * A soft_limit caps the heap below max_heap. When mem_sbrk would take the
+ * heap past either limit, it first calls the purge hook of the allocator
+ * (mem_set_purge), which should empty its caches and trim the heap, then
+ * the application's reclaim callbacks (mem_add_reclaim) one by one, which
+ * may free memory, until the request fits; only then does it fail.
+ *
+ * mem_copy() moves the payload of a block for realloc. Copies from
+ * stream_min bytes on, by default half the last level cache, use
+ * non-temporal stores, so a large move does not evict the working set.
+ *
+ * Blocks too large for the heap can have a mapping of their own
+ * (mem_map_block). mem_remap_block() resizes one with mremap, which moves
+ * page table entries instead of bytes. Mapped blocks count against the
+ * heap limits and are unmapped by mem_reset_brk().
+ *
+ * With memfd set the heap is a shared mapping of a memfd rather than
+ * anonymous memory. mem_move_pages() then moves whole pages inside the
+ * heap by mapping their memfd pages at a new address, so an allocator can
+ * move the page aligned interior of a large block without copying it. Each
+ * move splits the heap mapping, so it suits large blocks only.
+ *
+ * For allocators that find the size of a block from its address alone,
+ * mem_regions_init() reserves a second range next to the heap, split into
+ * equal power-of-two subregions that mem_region_sbrk() grows one at a
+ * time. The regions count against the heap limits; mem_footprint() is the
+ * heap size plus the region sizes.
+ *
+ * mem_grow() extends the heap by at least the bytes an allocator needs,
+ * choosing the amount itself: a share of the current heap size, so the
+ * number of growth calls stays logarithmic in the heap size, rounded so the
+ * brk ends on a page (or huge page) boundary. mem_trim() shrinks the heap,
+ * giving the pages above the new brk back if release_pages is set; each trim
+ * makes the following growth steps smaller, so a heap that shrinks does not
+ * overshoot again.
  */
 #ifndef __2025_04_15_MEMLIB_H__
 #define __2025_04_15_MEMLIB_H__
 
 #include <stddef.h>            // size_t
 
+/* Transparent huge page policy for the heap mapping */
+typedef enum
+{
+   MEM_THP_DEFAULT,     /* leave it to the system setting                */
+   MEM_THP_NEVER,       /* madvise( MADV_NOHUGEPAGE )                    */
+   MEM_THP_ALWAYS       /* huge page aligned, madvise( MADV_HUGEPAGE )   */
+} mem_thp_t;
+
+/* When the pages of the heap take their first page fault */
+typedef enum
+{
+   MEM_PREFAULT_NONE,   /* on first use by the allocator                 */
+   MEM_PREFAULT_SBRK,   /* in mem_sbrk, for the pages it hands out       */
+   MEM_PREFAULT_ALL     /* in mem_init, for the whole heap (MAP_POPULATE) */
+} mem_prefault_t;
+
+typedef struct
+{
+   size_t         max_heap;        /* bytes of address space reserved for the heap         */
+   int            release_pages;   /* mem_reset_brk and mem_trim give pages back to the OS */
+   mem_thp_t      huge_pages;
+   mem_prefault_t prefault;
+   size_t         prefault_ahead;  /* a background thread keeps this many bytes above     */
+                                   /* mem_brk pre-faulted; 0 for no thread                */
+   void*          base_addr;       /* fixed heap address, or NULL to let the OS choose    */
+   size_t         align;           /* alignment of the heap start; 0 for the page size    */
+   size_t         soft_limit;      /* heap size at which memory is reclaimed; 0 for none  */
+   size_t         stream_min;      /* mem_copy streams copies this large; 0 for LLC / 2   */
+   int            memfd;           /* back the heap with a memfd for mem_move_pages       */
+} mem_config_t;
+
+/* Called when the heap would grow beyond its limit; excess is the overshoot in bytes */
+typedef void ( *mem_reclaim_fn )( size_t excess, void* arg );
+
+/* A base_addr far from where Linux puts the program, its heap and its mappings */
+#define MEM_FIXED_BASE ( ( void* )0x200000000000 )
+
+/* Counters of heap growth and page hints since mem_init or the last mem_reset_brk */
+typedef struct
+{
+   long   grow_calls;   /* mem_grow calls that extended the heap          */
+   long   trim_calls;   /* mem_trim calls                                 */
+   size_t requested;    /* bytes the callers of mem_grow needed           */
+   size_t grown;        /* bytes mem_grow extended the heap by            */
+   size_t trimmed;      /* bytes mem_trim gave back                       */
+   size_t peak_heap;    /* largest footprint: heap plus regions           */
+   size_t cold;         /* bytes mem_advise_cold hinted with MADV_COLD    */
+   size_t paged_out;    /* bytes mem_advise_cold hinted with MADV_PAGEOUT */
+   long   limit_hits;   /* mem_sbrk calls that ran into the heap limit    */
+   long   limit_fails;  /* ... and failed after reclaiming                */
+   size_t copied;       /* bytes moved with mem_copy                      */
+   size_t streamed;     /* ... of those, with non-temporal stores         */
+   long   remaps;       /* mem_remap_block calls                          */
+   size_t remapped;     /* bytes they kept without copying                */
+   size_t moved;        /* bytes mem_move_pages moved without copying     */
+} mem_growth_t;
+
+void   mem_config_default( mem_config_t* config );
+void   mem_init_config( const mem_config_t* config );
+
 void   mem_init( void );
 void*  mem_sbrk( int incr );
+void*  mem_grow( size_t need, size_t* got );
+size_t mem_grow_size( size_t need );
+int    mem_trim( size_t bytes );
+void   mem_growth( mem_growth_t* stats );
+size_t mem_advise_cold( void* lo, void* hi, int pageout );
+double mem_pressure( void );
+void   mem_set_purge( void ( *purge )( void ) );
+int    mem_add_reclaim( mem_reclaim_fn fn, void* arg );
+
+void   mem_copy( void* dst, const void* src, size_t n );
+size_t mem_stream_threshold( void );
+
+int    mem_pages_movable( void );
+int    mem_move_pages( void* dst, void* src, size_t len );
+
+void*  mem_map_block( size_t len );
+void*  mem_remap_block( void* p, size_t len );
+void   mem_unmap_block( void* p );
+
+int    mem_regions_init( int n, size_t span );
+void*  mem_region_sbrk( int r, size_t incr );
+void*  mem_region_lo( int r );
+size_t mem_region_size( int r );
+size_t mem_region_span( void );
+size_t mem_footprint( void );
+int    mem_in_heap( const void* p, size_t size );
 
 void   mem_deinit( void );
 void   mem_reset_brk( void );
@@ -27,6 +160,8 @@ void*  mem_heap_lo( void );
 void*  mem_heap_hi( void );
 size_t mem_heapsize( void );
 size_t mem_pagesize( void );
+size_t mem_hugepagesize( void );
+size_t mem_resident( void );
 
 
 #endif  // __2025_04_15_MEMLIB_H__
\ No newline at end of file
@@ -0,0 +1,877 @@
+/**
+ * @file    mm.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Source file for mm.h
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Source:  Adapted from CSAPP
+ *
+ * Implicit free list allocator with boundary tag coalescing and first-fit,
+ * next-fit or best-fit placement.
+ *
+ * Every block carries a one word header and a one word footer holding the
+ * block size and an allocated bit. Block sizes are multiples of DSIZE, so
+ * payloads are DSIZE aligned. The heap is bracketed by an allocated
+ * prologue block and a zero size epilogue header:
+ *
+ *    | pad | prologue hdr | prologue ftr | block ... block | epilogue hdr |
+ *
+ * Free blocks are found by walking the heap; adjacent free blocks are
+ * merged immediately when a block is freed. First fit walks from the
+ * prologue. Next fit walks from a rover, the block where the previous
+ * search ended, wrapping around; a merge that swallows the rover's block
+ * moves the rover to the merged block. Best fit walks the whole heap for
+ * the smallest block that fits, but stops at the first block that is
+ * within good_pct percent of the request.
+ *
+ * With a split threshold set, a request of at least split_large bytes is
+ * placed at the end of the free block it splits, and smaller requests at
+ * the front, so small and large blocks collect at opposite ends of free
+ * areas. The top block is always split at the front, to keep its free
+ * part next to the brk.
+ *
+ * The heap grows through mem_grow, which picks a step in proportion to the
+ * heap size. When a free block of at least TRIM_THRESHOLD bytes ends the
+ * heap, all but TOP_PAD bytes of it are trimmed off with mem_trim. When
+ * memlib reaches the heap limit, its purge hook trims that block entirely.
+ *
+ * In wilderness mode the free block that ends the heap, the wilderness, is
+ * kept out of the first-fit search: small requests are placed in free
+ * blocks elsewhere whenever one fits, and only then carved off the front
+ * of the wilderness, which grows through mem_grow by what it lacks. The
+ * allocator counts the free blocks below the wilderness, so while there
+ * are none, as on a fresh heap, malloc skips the search and bumps the
+ * wilderness directly.
+ *
+ * Requests of at least mmap_min bytes get a memlib mapping of their own
+ * instead of heap space. The payload starts DSIZE bytes into the mapping,
+ * after a padding word and a header with the MAPPED bit set; there is no
+ * footer, since a mapped block has no neighbours. Freeing one unmaps it,
+ * and realloc resizes it with mem_remap_block, which moves page table
+ * entries rather than bytes, so growing a huge buffer costs time in
+ * proportion to its pages instead of its bytes.
+ *
+ * When memlib backs the heap with a memfd, realloc moves a block of at
+ * least MM_MOVE_MIN bytes that cannot grow in place without copying most of
+ * it: the new block is placed so that its payload has the same offset in
+ * its page as the old one, by splitting a free block of at least a page
+ * more, and the whole pages of the old payload are moved over with
+ * mem_move_pages. Only the partial pages at either end are copied.
+ * Remapping costs a system call and the page faults of the new mapping,
+ * so below MM_MOVE_MIN copying the bytes is faster.
+ *
+ * In cold mode every free block holds in its first payload word the
+ * request count at which it became free. Every cold_idle / 2 requests the
+ * heap is swept, and the pages inside free blocks that have been free for
+ * cold_idle requests are hinted cold, once; the stamp is then set to
+ * COLD_DONE.
+ */
+#include "mm.h"
+#include "memlib.h"
+
+#include <stdint.h>         // uintptr_t
+
+
+// =======================
+// Constants and Macros
+// =======================
+
+#define WSIZE     8                 /* word and header/footer size (bytes) */
+#define DSIZE     16                /* double word size (bytes)            */
+#define CHUNKSIZE ( 1 << 12 )       /* initial heap size (bytes)           */
+
+#define TRIM_THRESHOLD ( 256 * 1024 ) /* trim a free top block this large  */
+#define TOP_PAD        ( 128 * 1024 ) /* free bytes left at the top by a trim */
+
+#define COLD_DONE      ( ~( size_t )0 ) /* stamp of a block already hinted cold */
+#define PRESSURE       10.0          /* PSI avg10 percent: page out, not just cold */
+#define MMAP_THRESHOLD ( 1 << 20 )   /* default size of a request given its own mapping */
+#define MAPPED         0x2           /* header bit of a block in its own mapping */
+
+/* Pack a size and allocated bit into a word */
+#define PACK( size, alloc ) ( ( size ) | ( alloc ) )
+
+/* Read and write a word at address p */
+#define GET( p )        ( *( size_t* )( p ) )
+#define PUT( p, val )   ( *( size_t* )( p ) = ( val ) )
+
+/* Read the size and allocated fields from address p */
+#define GET_SIZE( p )   ( GET( p ) & ~( size_t )( DSIZE - 1 ) )
+#define GET_ALLOC( p )  ( GET( p ) & 0x1 )
+
+/* Given block ptr bp, compute address of its header and footer */
+#define HDRP( bp )      ( ( char* )( bp ) - WSIZE )
+#define FTRP( bp )      ( ( char* )( bp ) + GET_SIZE( HDRP( bp ) ) - DSIZE )
+
+/* Given block ptr bp, compute address of next and previous blocks */
+#define NEXT_BLKP( bp ) ( ( char* )( bp ) + GET_SIZE( ( char* )( bp ) - WSIZE ) )
+#define PREV_BLKP( bp ) ( ( char* )( bp ) - GET_SIZE( ( char* )( bp ) - DSIZE ) )
+
+/* Whether block ptr bp is in a mapping of its own */
+#define IS_MAPPED( bp ) ( GET( HDRP( bp ) ) & MAPPED )
+
+/* Whether block ptr bp is the last block of the heap */
+#define IS_TOP( bp )    ( GET_SIZE( HDRP( NEXT_BLKP( bp ) ) ) == 0 )
+
+
+// ==========================
+// Private Global Variables
+// ==========================
+
+static char* heap_listp = NULL;    /* Pointer to the prologue block */
+
+static long   cold_idle   = 0;      /* requests before a free block is cold; 0: off */
+static long   cold_next   = 0;      /* cold_idle from the next mm_init on            */
+static size_t requests    = 0;      /* mm_malloc and mm_free calls                   */
+static size_t next_sweep  = 0;      /* request count of the next cold sweep          */
+static int    wilderness  = 0;      /* keep the top block for when nothing else fits */
+static int    wild_next   = 0;      /* wilderness from the next mm_init on           */
+static long   free_blocks = 0;      /* free blocks other than the top block          */
+
+static mm_fit_t fit         = MM_FIRST_FIT;  /* placement policy                      */
+static mm_fit_t fit_next    = MM_FIRST_FIT;  /* fit from the next mm_init on          */
+static int      good_pct    = 0;       /* best fit: stop within this percent      */
+static int      good_next   = 0;       /* good_pct from the next mm_init on       */
+static size_t   split_large = 0;       /* place blocks this large at the end; 0: off */
+static size_t   split_next  = 0;       /* split_large from the next mm_init on    */
+static char*    rover       = NULL;    /* next fit: where the next search starts  */
+static size_t   mmap_min    = MMAP_THRESHOLD;  /* map requests this large; 0: off */
+static size_t   mmap_next   = MMAP_THRESHOLD;  /* mmap_min from the next mm_init on */
+
+
+// ==========================
+// Private Helper Functions
+// ==========================
+
+static void* extend_heap( size_t words );
+static void* coalesce( void* bp );
+static void* find_fit( size_t asize );
+static void* place( void* bp, size_t asize );
+static void  split_front( char* bp, size_t asize, size_t csize );
+static void  trim_heap( void* bp, size_t keep );
+static void  stamp( void* bp );
+
+
+/*
+ * too_large - whether a request of size bytes would overflow the rounding
+ *             to blocks or pages; no such request can be met anyway
+ */
+static int too_large( size_t size )
+{
+   return size > ( size_t )-1 - DSIZE - mem_pagesize();
+}
+
+
+/*
+ * adjust_size - block size needed for a payload of size bytes
+ */
+static size_t adjust_size( size_t size )
+{
+   if ( size <= DSIZE )
+      return 2 * DSIZE;
+
+   return DSIZE * ( ( size + DSIZE + ( DSIZE - 1 ) ) / DSIZE );
+}
+
+
+/*
+ * counted - whether bp is a free block other than the top block
+ */
+static int counted( void* bp )
+{
+   return !GET_ALLOC( HDRP( bp ) ) && !IS_TOP( bp );
+}
+
+
+/*
+ * top_block - the free block that ends the heap, or NULL
+ */
+static char* top_block( void )
+{
+   char* brk = ( char* )mem_heap_hi() + 1;
+
+   /* brk - DSIZE is the footer of the last block */
+   return GET_ALLOC( brk - DSIZE ) ? NULL : brk - GET_SIZE( brk - DSIZE );
+}
+
+
+/*
+ * stamp - record in a new free block when it became free (cold mode only)
+ */
+static void stamp( void* bp )
+{
+   if ( cold_idle > 0 )
+      PUT( bp, requests );
+}
+
+
+/*
+ * cold_sweep - hint the pages of long idle free blocks as cold
+ */
+static void cold_sweep( void )
+{
+   int   pageout = mem_pressure() > PRESSURE;
+   char* bp;
+
+   next_sweep = requests + ( cold_idle + 1 ) / 2;
+
+   for ( bp = heap_listp; GET_SIZE( HDRP( bp ) ) > 0; bp = NEXT_BLKP( bp ) )
+   {
+      if ( GET_ALLOC( HDRP( bp ) ) || GET( bp ) == COLD_DONE || requests - GET( bp ) < ( size_t )cold_idle )
+         continue;
+
+      /* Leave the page with the stamp alone, it is written again on reuse */
+      mem_advise_cold( bp + WSIZE, FTRP( bp ), pageout );
+      PUT( bp, COLD_DONE );
+   }
+}
+
+
+/*
+ * extend_heap - extend the heap with a free block of at least words words
+ *               and return its block pointer
+ */
+static void* extend_heap( size_t words )
+{
+   char*  bp;
+   size_t size;
+
+   /* Ask for an even number of words to maintain alignment; mem_grow
+      keeps the brk DSIZE aligned as it rounds the step to pages */
+   size = ( words % 2 ) ? ( words + 1 ) * WSIZE : words * WSIZE;
+
+   if ( ( long )( bp = mem_grow( size, &size ) ) == -1 )
+      return NULL;
+
+   /* Initialize free block header/footer and the epilogue header */
+   PUT( HDRP( bp ), PACK( size, 0 ) );            /* Free block header   */
+   PUT( FTRP( bp ), PACK( size, 0 ) );            /* Free block footer   */
+   PUT( HDRP( NEXT_BLKP( bp ) ), PACK( 0, 1 ) );  /* New epilogue header */
+
+   /* Coalesce if the previous block was free */
+   bp = coalesce( bp );
+   stamp( bp );
+   return bp;
+}
+
+
+/*
+ * coalesce - boundary tag coalescing. Return ptr to coalesced block
+ */
+static void* coalesce( void* bp )
+{
+   size_t prev_alloc = GET_ALLOC( FTRP( PREV_BLKP( bp ) ) );
+   size_t next_alloc = GET_ALLOC( HDRP( NEXT_BLKP( bp ) ) );
+   size_t size       = GET_SIZE( HDRP( bp ) );
+
+   if ( prev_alloc && next_alloc )                /* Case 1 */
+   {
+      return bp;
+   }
+   else if ( prev_alloc && !next_alloc )          /* Case 2 */
+   {
+      size += GET_SIZE( HDRP( NEXT_BLKP( bp ) ) );
+      PUT( HDRP( bp ), PACK( size, 0 ) );
+      PUT( FTRP( bp ), PACK( size, 0 ) );
+   }
+   else if ( !prev_alloc && next_alloc )          /* Case 3 */
+   {
+      size += GET_SIZE( HDRP( PREV_BLKP( bp ) ) );
+      PUT( FTRP( bp ), PACK( size, 0 ) );
+      PUT( HDRP( PREV_BLKP( bp ) ), PACK( size, 0 ) );
+      bp = PREV_BLKP( bp );
+   }
+   else                                           /* Case 4 */
+   {
+      size += GET_SIZE( HDRP( PREV_BLKP( bp ) ) ) + GET_SIZE( FTRP( NEXT_BLKP( bp ) ) );
+      PUT( HDRP( PREV_BLKP( bp ) ), PACK( size, 0 ) );
+      PUT( FTRP( NEXT_BLKP( bp ) ), PACK( size, 0 ) );
+      bp = PREV_BLKP( bp );
+   }
+
+   /* Keep the rover off the inside of the merged block */
+   if ( rover > ( char* )bp && rover < NEXT_BLKP( bp ) )
+      rover = bp;
+
+   return bp;
+}
+
+
+/*
+ * fits - whether bp is a free block that can take asize bytes; in
+ *        wilderness mode the top block never does
+ */
+static int fits( void* bp, size_t asize )
+{
+   return !GET_ALLOC( HDRP( bp ) ) && asize <= GET_SIZE( HDRP( bp ) ) && !( wilderness && IS_TOP( bp ) );
+}
+
+
+/*
+ * find_fit - search the implicit free list as the placement policy says
+ */
+static void* find_fit( size_t asize )
+{
+   char*  bp;
+   char*  best = NULL;
+   size_t good = asize + asize * good_pct / 100;
+
+   switch ( fit )
+   {
+      case MM_NEXT_FIT:
+         for ( bp = rover; GET_SIZE( HDRP( bp ) ) > 0; bp = NEXT_BLKP( bp ) )
+            if ( fits( bp, asize ) )
+               return rover = bp;
+
+         for ( bp = heap_listp; bp < rover; bp = NEXT_BLKP( bp ) )
+            if ( fits( bp, asize ) )
+               return rover = bp;
+
+         return NULL;
+
+      case MM_BEST_FIT:
+         for ( bp = heap_listp; GET_SIZE( HDRP( bp ) ) > 0; bp = NEXT_BLKP( bp ) )
+         {
+            if ( !fits( bp, asize ) || ( best != NULL && GET_SIZE( HDRP( bp ) ) >= GET_SIZE( HDRP( best ) ) ) )
+               continue;
+
+            best = bp;
+            if ( GET_SIZE( HDRP( bp ) ) <= good )
+               break;
+         }
+         return best;
+
+      default:
+         for ( bp = heap_listp; GET_SIZE( HDRP( bp ) ) > 0; bp = NEXT_BLKP( bp ) )
+            if ( fits( bp, asize ) )
+               return bp;
+
+         return NULL;    /* No fit */
+   }
+}
+
+
+/*
+ * place - place block of asize bytes in free block bp and split if the
+ *         remainder would be at least minimum block size; a large block
+ *         goes at the end of bp when split_large is set
+ *
+ * Return: the block pointer of the placed block
+ */
+static void* place( void* bp, size_t asize )
+{
+   size_t csize = GET_SIZE( HDRP( bp ) );
+
+   free_blocks -= counted( bp );
+
+   if ( split_large > 0 && asize >= split_large && csize - asize >= 2 * DSIZE && !IS_TOP( bp ) )
+   {
+      char* front = bp;
+
+      PUT( HDRP( front ), PACK( csize - asize, 0 ) );
+      PUT( FTRP( front ), PACK( csize - asize, 0 ) );
+      stamp( front );
+      bp = NEXT_BLKP( front );
+      PUT( HDRP( bp ), PACK( asize, 1 ) );
+      PUT( FTRP( bp ), PACK( asize, 1 ) );
+
+      /* Count the remainder once the header IS_TOP reads is written */
+      free_blocks += counted( front );
+   }
+   else
+   {
+      split_front( bp, asize, csize );
+   }
+
+   return bp;
+}
+
+
+/*
+ * split_front - make the first asize bytes of the csize byte area at bp an
+ *               allocated block, and the rest a free block if it is at
+ *               least the minimum block size
+ */
+static void split_front( char* bp, size_t asize, size_t csize )
+{
+   if ( ( csize - asize ) >= ( 2 * DSIZE ) )
+   {
+      PUT( HDRP( bp ), PACK( asize, 1 ) );
+      PUT( FTRP( bp ), PACK( asize, 1 ) );
+      PUT( HDRP( NEXT_BLKP( bp ) ), PACK( csize - asize, 0 ) );
+      PUT( FTRP( NEXT_BLKP( bp ) ), PACK( csize - asize, 0 ) );
+      stamp( NEXT_BLKP( bp ) );
+      free_blocks += counted( NEXT_BLKP( bp ) );
+   }
+   else
+   {
+      PUT( HDRP( bp ), PACK( csize, 1 ) );
+      PUT( FTRP( bp ), PACK( csize, 1 ) );
+   }
+}
+
+
+/*
+ * find_space - a free block of at least asize bytes: one found by the
+ *              placement policy, or the wilderness grown by what it lacks,
+ *              or a new block at the top of the heap; NULL if memlib is full
+ */
+static void* find_space( size_t asize )
+{
+   size_t top = 0;    /* Size of the wilderness */
+   char*  bp;
+
+   /* With no free block below the wilderness there is nothing to search */
+   if ( ( !wilderness || free_blocks > 0 ) && ( bp = find_fit( asize ) ) != NULL )
+      return bp;
+
+   if ( wilderness && ( bp = top_block() ) != NULL )
+      top = GET_SIZE( HDRP( bp ) );
+
+   if ( top >= asize )
+      return bp;
+
+   if ( ( bp = extend_heap( ( asize - top ) / WSIZE ) ) == NULL )
+      return NULL;
+
+   /* At the heap limit the purge hook may have trimmed the wilderness
+      before the growth, leaving the block short; grow by all of it */
+   if ( GET_SIZE( HDRP( bp ) ) < asize )
+      bp = extend_heap( asize / WSIZE );
+
+   return bp;
+}
+
+
+/*
+ * malloc_congruent - allocate a block with size bytes of payload at the
+ *                    same offset in its page as like
+ *
+ * A free block of a page more than needed is split into a free block in
+ * front, of at least the minimum block size, and the new block.
+ */
+static void* malloc_congruent( size_t size, const void* like )
+{
+   size_t page  = mem_pagesize();
+   size_t asize = adjust_size( size );
+   size_t csize;
+   size_t lead;
+   char*  bp;
+
+   if ( cold_idle > 0 && ++requests >= next_sweep )
+      cold_sweep();
+
+   if ( asize > ( size_t )-1 - page - 2 * DSIZE || ( bp = find_space( asize + page + 2 * DSIZE ) ) == NULL )
+      return NULL;
+
+   /* bp and like are both DSIZE aligned, and so is lead */
+   lead  = 2 * DSIZE + ( ( uintptr_t )like - ( uintptr_t )( bp + 2 * DSIZE ) ) % page;
+   csize = GET_SIZE( HDRP( bp ) );
+
+   free_blocks -= counted( bp );
+   PUT( HDRP( bp ), PACK( lead, 0 ) );
+   PUT( FTRP( bp ), PACK( lead, 0 ) );
+   stamp( bp );
+   split_front( bp + lead, asize, csize - lead );
+
+   /* Count the front block once the header IS_TOP reads is written */
+   free_blocks += counted( bp );
+   return bp + lead;
+}
+
+
+/*
+ * move_payload - move n bytes of payload from src to dst, which have the
+ *                same offset in their pages: the whole pages by moving
+ *                them, the partial pages at either end by copying
+ */
+static void move_payload( char* dst, char* src, size_t n )
+{
+   size_t page = mem_pagesize();
+   size_t head = ( page - ( uintptr_t )src % page ) % page;
+   size_t body = n > head ? ( n - head ) & ~( page - 1 ) : 0;
+
+   if ( body == 0 || mem_move_pages( dst + head, src + head, body ) < 0 )
+   {
+      mem_copy( dst, src, n );
+      return;
+   }
+
+   mem_copy( dst, src, head );
+   mem_copy( dst + head + body, src + head + body, n - head - body );
+}
+
+
+/*
+ * map_size - bytes of the mapping for a block with size bytes of payload;
+ *            memlib rounds mappings up to pages
+ */
+static size_t map_size( size_t size )
+{
+   size_t page = mem_pagesize();
+
+   return ( size + DSIZE + page - 1 ) & ~( page - 1 );
+}
+
+
+/*
+ * map_block - allocate a block with size bytes of payload in a mapping of
+ *             its own
+ */
+static void* map_block( size_t size )
+{
+   char* p;
+
+   if ( ( p = mem_map_block( size + DSIZE ) ) == NULL )
+      return NULL;
+
+   PUT( p + WSIZE, PACK( map_size( size ), MAPPED | 1 ) );
+   return p + DSIZE;
+}
+
+
+/*
+ * remap_block - resize the mapped block bp to size bytes of payload
+ */
+static void* remap_block( void* bp, size_t size )
+{
+   char* p;
+
+   if ( ( p = mem_remap_block( ( char* )bp - DSIZE, size + DSIZE ) ) == NULL )
+      return NULL;
+
+   PUT( p + WSIZE, PACK( map_size( size ), MAPPED | 1 ) );
+   return p + DSIZE;
+}
+
+
+/*
+ * trim_heap - give all but keep bytes of the free block bp, which ends the
+ *             heap, back to memlib; keep is 0 or at least CHUNKSIZE
+ */
+static void trim_heap( void* bp, size_t keep )
+{
+   size_t size = GET_SIZE( HDRP( bp ) );
+   size_t trim = keep ? ( size - keep ) & ~( size_t )( CHUNKSIZE - 1 ) : size;
+
+   if ( trim == 0 || mem_trim( trim ) < 0 )
+      return;
+
+   size -= trim;
+   if ( size > 0 )
+   {
+      PUT( HDRP( bp ), PACK( size, 0 ) );
+      PUT( FTRP( bp ), PACK( size, 0 ) );
+   }
+   PUT( HDRP( bp ) + size, PACK( 0, 1 ) );        /* New epilogue header */
+}
+
+
+/*
+ * purge - memlib purge hook: trim the whole free block at the end of the heap
+ */
+static void purge( void )
+{
+   char* bp = top_block();
+
+   if ( bp != NULL )
+      trim_heap( bp, 0 );
+}
+
+
+// ==========================
+// Public Functions
+// ==========================
+
+/*
+ * mm_init - initialize the memory manager
+ *
+ * Return: 0 on success, -1 if the initial heap could not be created
+ */
+int mm_init( void )
+{
+   /* Create the initial empty heap */
+   if ( ( heap_listp = mem_sbrk( 4 * WSIZE ) ) == ( void* )-1 )
+      return -1;
+
+   PUT( heap_listp, 0 );                              /* Alignment padding */
+   PUT( heap_listp + ( 1 * WSIZE ), PACK( DSIZE, 1 ) ); /* Prologue header   */
+   PUT( heap_listp + ( 2 * WSIZE ), PACK( DSIZE, 1 ) ); /* Prologue footer   */
+   PUT( heap_listp + ( 3 * WSIZE ), PACK( 0, 1 ) );     /* Epilogue header   */
+   heap_listp += ( 2 * WSIZE );
+   rover       = heap_listp;
+
+   mem_set_purge( purge );
+
+   cold_idle   = cold_next;
+   wilderness  = wild_next;
+   fit         = fit_next;
+   good_pct    = good_next;
+   split_large = split_next;
+   mmap_min    = mmap_next;
+   free_blocks = 0;
+   requests    = 0;
+   next_sweep  = ( cold_idle + 1 ) / 2;
+
+   /* Extend the empty heap with a free block of CHUNKSIZE bytes */
+   if ( extend_heap( CHUNKSIZE / WSIZE ) == NULL )
+      return -1;
+
+   return 0;
+}
+
+
+/*
+ * mm_malloc - allocate a block with at least size bytes of payload
+ */
+void* mm_malloc( size_t size )
+{
+   size_t asize;      /* Adjusted block size                */
+   char*  bp;
+
+   if ( heap_listp == NULL )
+      mm_init();
+
+   /* Ignore spurious requests */
+   if ( size == 0 || too_large( size ) )
+      return NULL;
+
+   if ( cold_idle > 0 && ++requests >= next_sweep )
+      cold_sweep();
+
+   if ( mmap_min > 0 && size >= mmap_min )
+      return map_block( size );
+
+   /* Adjust block size to include overhead and alignment reqs */
+   asize = adjust_size( size );
+
+   /* Search the free list for a fit, or carve the block off the
+      wilderness, or get more memory for the whole block */
+   if ( ( bp = find_space( asize ) ) == NULL )
+      return NULL;
+
+   return place( bp, asize );
+}
+
+
+/*
+ * mm_free - free a block
+ */
+void mm_free( void* bp )
+{
+   size_t size;
+
+   if ( bp == NULL )
+      return;
+
+   if ( IS_MAPPED( bp ) )
+   {
+      mem_unmap_block( ( char* )bp - DSIZE );
+      return;
+   }
+
+   size = GET_SIZE( HDRP( bp ) );
+
+   PUT( HDRP( bp ), PACK( size, 0 ) );
+   PUT( FTRP( bp ), PACK( size, 0 ) );
+   free_blocks -= counted( PREV_BLKP( bp ) ) + counted( NEXT_BLKP( bp ) );
+   bp = coalesce( bp );
+   free_blocks += counted( bp );
+   stamp( bp );
+
+   if ( cold_idle > 0 && ++requests >= next_sweep )
+      cold_sweep();
+
+   /* A large free block at the end of the heap goes back to memlib */
+   if ( GET_SIZE( HDRP( NEXT_BLKP( bp ) ) ) == 0 && GET_SIZE( HDRP( bp ) ) >= TRIM_THRESHOLD )
+      trim_heap( bp, TOP_PAD );
+}
+
+
+/*
+ * mm_realloc - resize a block, keeping it in place when it is already large
+ *              enough; a mapped block that stays at least mmap_min bytes is
+ *              remapped instead of copied, and a large block in a memfd
+ *              backed heap has its pages moved
+ */
+void* mm_realloc( void* ptr, size_t size )
+{
+   size_t oldsize;
+   void*  newptr;
+
+   /* If size == 0 then this is just free, and we return NULL. */
+   if ( size == 0 )
+   {
+      mm_free( ptr );
+      return NULL;
+   }
+
+   /* If oldptr is NULL, then this is just malloc. */
+   if ( ptr == NULL )
+      return mm_malloc( size );
+
+   if ( too_large( size ) )
+      return NULL;
+
+   oldsize = GET_SIZE( HDRP( ptr ) ) - DSIZE;
+
+   if ( IS_MAPPED( ptr ) && size >= mmap_min )
+      return remap_block( ptr, size );
+
+   if ( size <= oldsize && !IS_MAPPED( ptr ) )
+      return ptr;
+
+   /* Blocks that go to a mapping of their own are copied there once */
+   if ( !IS_MAPPED( ptr ) && oldsize >= MM_MOVE_MIN && ( mmap_min == 0 || size < mmap_min ) && mem_pages_movable() )
+   {
+      if ( ( newptr = malloc_congruent( size, ptr ) ) == NULL )
+         return NULL;
+
+      move_payload( newptr, ptr, oldsize );
+      mm_free( ptr );
+      return newptr;
+   }
+
+   if ( ( newptr = mm_malloc( size ) ) == NULL )
+      return NULL;
+
+   mem_copy( newptr, ptr, size < oldsize ? size : oldsize );
+   mm_free( ptr );
+
+   return newptr;
+}
+
+
+/*
+ * mm_check - check the heap: aligned blocks with matching header and footer
+ *            between the prologue and an epilogue at the brk, no two free
+ *            blocks next to each other, and the count of free blocks below
+ *            the top block right
+ *
+ * Return: 0 if the heap is consistent, -1 otherwise
+ */
+int mm_check( void )
+{
+   char* bp;
+   long  nfree     = 0;
+   int   prev_free = 0;
+
+   if ( heap_listp == NULL )
+      return 0;
+
+   if ( GET_SIZE( HDRP( heap_listp ) ) != DSIZE || !GET_ALLOC( HDRP( heap_listp ) ) )
+      return -1;
+
+   for ( bp = NEXT_BLKP( heap_listp ); GET_SIZE( HDRP( bp ) ) > 0; bp = NEXT_BLKP( bp ) )
+   {
+      if ( ( size_t )bp % DSIZE != 0 || GET( HDRP( bp ) ) != GET( FTRP( bp ) ) || IS_MAPPED( bp ) )
+         return -1;
+
+      if ( !GET_ALLOC( HDRP( bp ) ) )
+      {
+         if ( prev_free )
+            return -1;
+         nfree += !IS_TOP( bp );
+      }
+      prev_free = !GET_ALLOC( HDRP( bp ) );
+   }
+
+   if ( !GET_ALLOC( HDRP( bp ) ) || bp != ( char* )mem_heap_hi() + 1 )
+      return -1;
+
+   return nfree == free_blocks ? 0 : -1;
+}
+
+
+/*
+ * mm_usable_size - bytes of payload of the block at ptr, which may exceed
+ *                  the size it was requested with; 0 for NULL
+ */
+size_t mm_usable_size( void* ptr )
+{
+   return ptr == NULL ? 0 : GET_SIZE( HDRP( ptr ) ) - DSIZE;
+}
+
+
+/*
+ * mm_good_size - bytes of payload mm_malloc( size ) reserves: the request
+ *                rounded up to the block size, or to pages for a block in
+ *                a mapping of its own; 0 for 0 and for sizes no block
+ *                can have
+ *
+ * A heap block may get more when the rest of the free block it is placed
+ * in is too small to split off; mm_usable_size tells.
+ */
+size_t mm_good_size( size_t size )
+{
+   if ( size == 0 || too_large( size ) )
+      return 0;
+
+   if ( mmap_min > 0 && size >= mmap_min )
+      return map_size( size ) - DSIZE;
+
+   return adjust_size( size ) - DSIZE;
+}
+
+
+/*
+ * mm_set_cold - hint free blocks idle for idle requests as cold; 0 turns this off
+ *
+ * Takes effect at the next mm_init.
+ */
+void mm_set_cold( long idle )
+{
+   cold_next = idle > 0 ? idle : 0;
+}
+
+
+/*
+ * mm_set_wilderness - keep the free block at the top of the heap for
+ *                     requests no other free block fits; 0 turns this off
+ *
+ * Takes effect at the next mm_init.
+ */
+void mm_set_wilderness( int on )
+{
+   wild_next = on;
+}
+
+
+/*
+ * mm_set_fit - placement policy; for best fit, good_pct ends the search at
+ *              the first block no more than good_pct percent too large
+ *
+ * Takes effect at the next mm_init.
+ */
+void mm_set_fit( mm_fit_t policy, int good )
+{
+   fit_next  = policy;
+   good_next = good > 0 ? good : 0;
+}
+
+
+/*
+ * mm_set_mmap - give requests of at least min bytes a mapping of their own;
+ *               0 keeps every block in the heap
+ *
+ * Takes effect at the next mm_init.
+ */
+void mm_set_mmap( size_t min )
+{
+   mmap_next = min;
+}
+
+
+/*
+ * mm_set_split - place blocks of at least large bytes at the end of the free
+ *                block they split; 0 places every block at the front
+ *
+ * Takes effect at the next mm_init.
+ */
+void mm_set_split( size_t large )
+{
+   split_next = large;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file    mm.h
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Dynamic storage allocator built on top of memlib
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Source:  Adapted from CSAPP
+ *
+ * mem_init() must be called once before mm_init(). Calling mem_reset_brk()
+ * followed by mm_init() starts over with an empty heap.
+ *
+ * mm_usable_size() is the payload a block really has and mm_good_size() the
+ * payload a request of a given size would get, so that a growing container
+ * can ask for a size that uses the padding and realloc less often.
+ *
+ * mm_check() walks the heap and checks its invariants, for tests.
+ *
+ * mm_set_cold( idle ) makes the allocator hint the pages of free blocks
+ * that stayed free for idle requests as cold (see mem_advise_cold), or as
+ * to be paged out when the system is under memory pressure; 0, the default,
+ * turns this off.
+ *
+ * mm_set_wilderness( 1 ) keeps the free block at the top of the heap out of
+ * the first-fit search, so that it is split only when no other free block
+ * fits; 0, the default, turns this off.
+ *
+ * mm_set_fit() chooses first fit (the default), next fit or best fit, and
+ * mm_set_split() a size from which blocks are placed at the end of the free
+ * block they split rather than at its front.
+ *
+ * mm_set_mmap( min ) gives requests of at least min bytes, 1 MB by default,
+ * a memlib mapping of their own, which realloc resizes with mremap rather
+ * than by copying; 0 keeps every block in the heap. Like the settings
+ * above it takes effect at the next mm_init().
+ *
+ * On a heap that memlib backs with a memfd, realloc moves a heap block of
+ * at least MM_MOVE_MIN bytes that cannot grow in place by remapping its
+ * pages rather than copying them.
+ */
+#ifndef __2026_10_18_MM_H__
+#define __2026_10_18_MM_H__
+
+#include <stddef.h>            // size_t
+
+#define MM_MOVE_MIN ( 16 << 20 )   /* realloc moves the pages of heap blocks this large */
+
+/* Placement policy of mm_malloc */
+typedef enum
+{
+   MM_FIRST_FIT,     /* first free block that fits, from the start of the heap  */
+   MM_NEXT_FIT,      /* first fit from where the previous search ended          */
+   MM_BEST_FIT       /* smallest free block that fits, or the first good enough */
+} mm_fit_t;
+
+int    mm_init( void );
+void*  mm_malloc( size_t size );
+void   mm_free( void* ptr );
+void*  mm_realloc( void* ptr, size_t size );
+size_t mm_usable_size( void* ptr );
+size_t mm_good_size( size_t size );
+int    mm_check( void );
+void   mm_set_cold( long idle );
+void   mm_set_wilderness( int on );
+void   mm_set_fit( mm_fit_t policy, int good_pct );
+void   mm_set_split( size_t large );
+void   mm_set_mmap( size_t min );
+
+#endif  // __2026_10_18_MM_H__
@@ -0,0 +1,248 @@
+/**
+ * @file    partition.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Source file for partition.h
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Size class c lives in memlib region c. The regions are consecutive and
+ * equally large, a power of two, starting at region_lo, so
+ *
+ *    class( p ) = ( p - region_lo ) >> span_shift
+ *
+ * and the usable size of a block is class_size[ class( p ) ]. Each region
+ * holds blocks of its class back to back from its start: blocks never
+ * freed are carved from the end of the region, which grows by at least
+ * REGION_STEP bytes at a time, and freed blocks go on a LIFO list of the
+ * class, linked through their first word.
+ *
+ * Memory freed to a class stays with that class; the allocator trades this
+ * for lookups that never touch a header, a page map or a neighbour block.
+ */
+#include "partition.h"
+#include "memlib.h"
+
+#include <stdint.h>         // uintptr_t
+
+
+// =======================
+// Constants and Macros
+// =======================
+
+#define ALIGNMENT   16
+#define MAX_CLASSES 68            /* 8 up to 128, then 4 per power of two */
+#define MAX_CLASS   ( 1 << 22 )   /* largest block: 4 MB                 */
+#define SMALL_LIMIT 2048          /* class_index covers sizes up to this */
+#define REGION_STEP ( 16 * 1024 ) /* least a region grows by             */
+
+#define ALIGN_UP( x, a )  ( ( ( uintptr_t )( x ) + ( a ) - 1 ) & ~( ( uintptr_t )( a ) - 1 ) )
+
+#define CLASS_OF( p ) ( ( int )( ( ( char* )( p ) - region_lo ) >> span_shift ) )
+
+
+// ==========================
+// Private Global Variables
+// ==========================
+
+static size_t        class_size[ MAX_CLASSES ];
+static int           nclasses;
+static unsigned char class_index[ SMALL_LIMIT / ALIGNMENT + 1 ];   /* by size / 16 */
+
+static char*    region_lo;                  /* start of region 0           */
+static unsigned span_shift;                 /* log2 of the region span     */
+static void*    free_list[ MAX_CLASSES ];
+static char*    carve[ MAX_CLASSES ];       /* next block never handed out */
+static char*    carve_end[ MAX_CLASSES ];   /* brk of the region           */
+
+
+// ==========================
+// Private Helper Functions
+// ==========================
+
+/*
+ * init_classes - multiples of 16 up to 128, then four per power of two
+ */
+static void init_classes( void )
+{
+   size_t size;
+   int    c;
+   int    i;
+
+   nclasses = 0;
+   for ( size = ALIGNMENT; size <= 128; size += ALIGNMENT )
+      class_size[ nclasses++ ] = size;
+
+   for ( size = 128; size < MAX_CLASS; size <<= 1 )
+      for ( i = 5; i <= 8; ++i )
+         class_size[ nclasses++ ] = size / 4 * i;
+
+   for ( c = 0, i = 0; i <= SMALL_LIMIT / ALIGNMENT; ++i )
+   {
+      while ( class_size[ c ] < ( size_t )i * ALIGNMENT )
+         ++c;
+      class_index[ i ] = ( unsigned char )c;
+   }
+}
+
+
+/*
+ * size_class - smallest class that holds size bytes, or -1
+ */
+static int size_class( size_t size )
+{
+   int c;
+
+   if ( size <= SMALL_LIMIT )
+      return class_index[ ( size + ALIGNMENT - 1 ) / ALIGNMENT ];
+
+   if ( size > MAX_CLASS )
+      return -1;
+
+   for ( c = class_index[ SMALL_LIMIT / ALIGNMENT ]; class_size[ c ] < size; ++c )
+      ;
+   return c;
+}
+
+
+/*
+ * carve_block - hand out the next block never used of class c, growing
+ *               its region when it is used up
+ */
+static void* carve_block( int c )
+{
+   size_t size = class_size[ c ];
+   char*  p;
+
+   if ( ( size_t )( carve_end[ c ] - carve[ c ] ) < size )
+   {
+      size_t step = size - ( carve_end[ c ] - carve[ c ] );
+
+      if ( step < REGION_STEP )
+         step = REGION_STEP;
+      step = ALIGN_UP( step, mem_pagesize() );
+
+      if ( mem_region_sbrk( c, step ) == ( void* )-1 )
+         return NULL;
+      carve_end[ c ] += step;
+   }
+
+   p           = carve[ c ];
+   carve[ c ] += size;
+   return p;
+}
+
+
+// ==========================
+// Public Functions
+// ==========================
+
+/*
+ * part_init - reserve one region per size class and start with none used
+ *
+ * Return: 0 on success, -1 if memlib cannot reserve the regions
+ */
+int part_init( void )
+{
+   size_t span;
+   int    c;
+
+   init_classes();
+
+   if ( mem_regions_init( nclasses, 0 ) < 0 )
+      return -1;
+
+   region_lo = ( char* )mem_region_lo( 0 );
+   span      = mem_region_span();
+   for ( span_shift = 0; ( ( size_t )1 << span_shift ) < span; ++span_shift )
+      ;
+
+   for ( c = 0; c < nclasses; ++c )
+   {
+      free_list[ c ] = NULL;
+      carve[ c ]     = ( char* )mem_region_lo( c );
+      carve_end[ c ] = carve[ c ];
+   }
+
+   /* There is nothing to give back without the block sizes of a header */
+   mem_set_purge( NULL );
+   return 0;
+}
+
+
+/*
+ * part_malloc - allocate a block with at least size bytes of payload
+ */
+void* part_malloc( size_t size )
+{
+   void* p;
+   int   c;
+
+   if ( size == 0 || ( c = size_class( size ) ) < 0 )
+      return NULL;
+
+   if ( ( p = free_list[ c ] ) != NULL )
+   {
+      free_list[ c ] = *( void** )p;
+      return p;
+   }
+
+   return carve_block( c );
+}
+
+
+/*
+ * part_free - free a block; its class comes from its address
+ */
+void part_free( void* ptr )
+{
+   int c;
+
+   if ( ptr == NULL )
+      return;
+
+   c              = CLASS_OF( ptr );
+   *( void** )ptr = free_list[ c ];
+   free_list[ c ] = ptr;
+}
+
+
+/*
+ * part_usable_size - bytes of payload of the block at ptr
+ */
+size_t part_usable_size( void* ptr )
+{
+   return ptr == NULL ? 0 : class_size[ CLASS_OF( ptr ) ];
+}
+
+
+/*
+ * part_realloc - resize a block, keeping it in place when its class is large enough
+ */
+void* part_realloc( void* ptr, size_t size )
+{
+   size_t oldsize;
+   void*  newptr;
+
+   if ( size == 0 )
+   {
+      part_free( ptr );
+      return NULL;
+   }
+
+   if ( ptr == NULL )
+      return part_malloc( size );
+
+   oldsize = part_usable_size( ptr );
+   if ( size <= oldsize )
+      return ptr;
+
+   if ( ( newptr = part_malloc( size ) ) == NULL )
+      return NULL;
+
+   mem_copy( newptr, ptr, oldsize );
+   part_free( ptr );
+
+   return newptr;
+}
@@ -0,0 +1,29 @@
+/**
+ * @file    partition.h
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Size-class allocator over per-class memlib regions, without headers
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Every size class has a memlib region of its own, so the class of a block,
+ * and with it its size, follows from its address by a subtraction and a
+ * shift. Blocks carry no header, and part_free() and part_usable_size()
+ * read no metadata to find the size.
+ *
+ * mem_init() must be called once before part_init(). Requests larger than
+ * the largest class (4 MB) fail.
+ */
+#ifndef __2026_10_18_PARTITION_H__
+#define __2026_10_18_PARTITION_H__
+
+#include <stddef.h>            // size_t
+
+int    part_init( void );
+void*  part_malloc( size_t size );
+void   part_free( void* ptr );
+void*  part_realloc( void* ptr, size_t size );
+size_t part_usable_size( void* ptr );
+
+#endif  // __2026_10_18_PARTITION_H__
@@ -0,0 +1,446 @@
+/**
+ * @file    side.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Source file for side.h
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The heap is an array of granules. Granule i has bit i in two bitmaps,
+ * each in a memlib region of its own:
+ *
+ *    start_map   1 if a block starts at granule i
+ *    alloc_map   for a block start: 1 if the block is allocated
+ *
+ * A block runs from its start bit to the next start bit, so its size is
+ * never stored, and an allocated epilogue bit at the end of the heap ends
+ * the last block. Freeing merges a block with free neighbours by clearing
+ * start bits; no header or footer is read or written.
+ *
+ * Placement is first fit. The walk looks only at the words of
+ * start_map & ~alloc_map, so it skips allocated blocks 64 granules at a
+ * time and never touches the heap. The bitmaps grow a page at a time,
+ * ahead of the heap; new pages are cleared, since memlib may hand back
+ * pages that an earlier run wrote. At the heap limit the purge hook trims
+ * a free block at the end of the heap, except while the allocator grows
+ * the heap itself: that block is about to be merged with the new memory,
+ * and trimming it would leave the request short.
+ */
+#include "side.h"
+#include "memlib.h"
+
+#include <stdint.h>         // uint64_t, uintptr_t
+#include <string.h>         // memset
+
+
+// =======================
+// Constants and Macros
+// =======================
+
+#define START_REGION 0
+#define ALLOC_REGION 1
+#define NONE         ( ~( size_t )0 )
+
+#define BIT( i )          ( ( uint64_t )1 << ( ( i ) & 63 ) )
+#define TEST( map, i )    ( ( map )[ ( i ) >> 6 ] & BIT( i ) )
+#define SET( map, i )     ( ( map )[ ( i ) >> 6 ] |= BIT( i ) )
+#define CLEAR( map, i )   ( ( map )[ ( i ) >> 6 ] &= ~BIT( i ) )
+
+/* Granule index of a payload and payload of a granule index */
+#define GRAN_OF( p )      ( ( size_t )( ( char* )( p ) - heap_lo ) >> gshift )
+#define PAYLOAD( i )      ( heap_lo + ( ( i ) << gshift ) )
+
+
+// ==========================
+// Private Global Variables
+// ==========================
+
+static size_t    granule = 16;     /* bytes per granule, a power of two */
+static unsigned  gshift;           /* log2 of granule                   */
+static char*     heap_lo;          /* granule 0                         */
+static size_t    heap_gran;        /* granules in the heap: the epilogue */
+static uint64_t* start_map;
+static uint64_t* alloc_map;
+static size_t    map_bytes;        /* bytes of each bitmap in use       */
+static int       growing;          /* inside extend_heap: purge is off  */
+
+
+// ==========================
+// Private Helper Functions
+// ==========================
+
+/*
+ * too_large - whether a request of size bytes would overflow the rounding
+ *             to granules or pages; no such request can be met anyway
+ */
+static int too_large( size_t size )
+{
+   return size > ( size_t )-1 - granule - mem_pagesize();
+}
+
+
+/*
+ * next_start - first block start at or after granule i; the epilogue
+ *              guarantees one
+ */
+static size_t next_start( size_t i )
+{
+   size_t   w    = i >> 6;
+   uint64_t bits = start_map[ w ] & ( ~( uint64_t )0 << ( i & 63 ) );
+
+   while ( bits == 0 )
+      bits = start_map[ ++w ];
+
+   return ( w << 6 ) + __builtin_ctzll( bits );
+}
+
+
+/*
+ * prev_start - last block start at or before granule i; granule 0 is one
+ */
+static size_t prev_start( size_t i )
+{
+   size_t   w    = i >> 6;
+   uint64_t bits = start_map[ w ] & ( ~( uint64_t )0 >> ( 63 - ( i & 63 ) ) );
+
+   while ( bits == 0 )
+      bits = start_map[ --w ];
+
+   return ( w << 6 ) + 63 - __builtin_clzll( bits );
+}
+
+
+/*
+ * next_free - first free block start at or after granule i, or NONE
+ */
+static size_t next_free( size_t i )
+{
+   size_t   w    = i >> 6;
+   size_t   last = heap_gran >> 6;
+   uint64_t bits = start_map[ w ] & ~alloc_map[ w ] & ( ~( uint64_t )0 << ( i & 63 ) );
+
+   while ( bits == 0 )
+   {
+      if ( ++w > last )
+         return NONE;
+      bits = start_map[ w ] & ~alloc_map[ w ];
+   }
+
+   return ( w << 6 ) + __builtin_ctzll( bits );
+}
+
+
+/*
+ * grow_maps - make the bitmaps cover granules [0, bits)
+ *
+ * Return: 0 on success, -1 if memlib is out of memory
+ */
+static int grow_maps( size_t bits )
+{
+   size_t need = ( ( bits + 63 ) >> 6 ) * sizeof( uint64_t );
+   size_t page = mem_pagesize();
+
+   while ( map_bytes < need )
+   {
+      if ( mem_region_sbrk( START_REGION, page ) == ( void* )-1
+           || mem_region_sbrk( ALLOC_REGION, page ) == ( void* )-1 )
+         return -1;
+
+      memset( ( char* )start_map + map_bytes, 0, page );
+      memset( ( char* )alloc_map + map_bytes, 0, page );
+      map_bytes += page;
+   }
+
+   return 0;
+}
+
+
+/*
+ * make_block - mark granule i as the start of a block
+ */
+static void make_block( size_t i, int alloc )
+{
+   SET( start_map, i );
+   if ( alloc )
+      SET( alloc_map, i );
+   else
+      CLEAR( alloc_map, i );
+}
+
+
+/*
+ * extend_heap - grow the heap by at least n granules
+ *
+ * The end of the heap is read after mem_grow, since reclaim callbacks run
+ * by it may call the allocator.
+ *
+ * Return: the start of the free block that now ends the heap, or NONE
+ */
+static size_t extend_heap( size_t n )
+{
+   size_t old_end;
+   size_t new_end;
+   size_t got;
+   size_t last;
+   void*  p;
+   int    ok;
+
+   growing = 1;
+   if ( ( p = mem_grow( n << gshift, &got ) ) == ( void* )-1 )
+   {
+      growing = 0;
+      return NONE;
+   }
+
+   old_end = GRAN_OF( p );
+   new_end = old_end + ( got >> gshift );
+   ok      = grow_maps( new_end + 1 ) == 0;
+   growing = 0;
+
+   if ( !ok )
+   {
+      mem_trim( got );
+      return NONE;
+   }
+
+   /* The old epilogue starts the new free block, merged with a free last block */
+   make_block( old_end, 0 );
+   make_block( new_end, 1 );
+   heap_gran = new_end;
+
+   if ( old_end == 0 )
+      return old_end;
+
+   last = prev_start( old_end - 1 );
+   if ( TEST( alloc_map, last ) )
+      return old_end;
+
+   CLEAR( start_map, old_end );
+   return last;
+}
+
+
+/*
+ * find_fit - first free block of at least n granules, or NONE
+ */
+static size_t find_fit( size_t n )
+{
+   size_t i = 0;
+   size_t f;
+
+   while ( ( f = next_free( i ) ) != NONE )
+   {
+      size_t end = next_start( f + 1 );
+
+      if ( end - f >= n )
+         return f;
+      i = end;
+   }
+
+   return NONE;
+}
+
+
+/*
+ * place - allocate n granules at the start of free block f, splitting if
+ *         the remainder is at least one granule
+ */
+static void place( size_t f, size_t n )
+{
+   SET( alloc_map, f );
+
+   if ( next_start( f + 1 ) - f > n )
+      make_block( f + n, 0 );
+}
+
+
+/*
+ * purge - memlib purge hook: trim a free block at the end of the heap
+ */
+static void purge( void )
+{
+   size_t last;
+
+   if ( heap_gran == 0 || growing )
+      return;
+
+   last = prev_start( heap_gran - 1 );
+   if ( TEST( alloc_map, last ) )
+      return;
+
+   if ( mem_trim( ( heap_gran - last ) << gshift ) == 0 )
+   {
+      CLEAR( start_map, heap_gran );
+      CLEAR( alloc_map, heap_gran );
+      SET( alloc_map, last );
+      heap_gran = last;
+   }
+}
+
+
+// ==========================
+// Public Functions
+// ==========================
+
+/*
+ * side_init - start over with an empty heap, on a page aligned brk
+ *
+ * Return: 0 on success, -1 if memlib cannot reserve the bitmaps or is full
+ */
+int side_init( void )
+{
+   size_t page = mem_pagesize();
+   size_t pad  = ( page - mem_heapsize() % page ) % page;
+
+   for ( gshift = 0; ( ( size_t )1 << gshift ) < granule; ++gshift )
+      ;
+
+   if ( mem_regions_init( 2, 0 ) < 0 )
+      return -1;
+
+   if ( pad > 0 && mem_sbrk( ( int )pad ) == ( void* )-1 )
+      return -1;
+
+   heap_lo   = ( char* )mem_heap_hi() + 1;
+   heap_gran = 0;
+   start_map = ( uint64_t* )mem_region_lo( START_REGION );
+   alloc_map = ( uint64_t* )mem_region_lo( ALLOC_REGION );
+   map_bytes = 0;
+
+   if ( grow_maps( 1 ) < 0 )
+      return -1;
+   make_block( 0, 1 );          /* epilogue */
+
+   mem_set_purge( purge );
+   return 0;
+}
+
+
+/*
+ * side_set_granule - payload alignment and allocation unit from the next
+ *                    side_init on; a power of two of at least 16 bytes
+ */
+void side_set_granule( size_t bytes )
+{
+   granule = bytes;
+}
+
+
+/*
+ * side_malloc - allocate a block with at least size bytes of payload
+ */
+void* side_malloc( size_t size )
+{
+   size_t n;
+   size_t f;
+
+   if ( size == 0 || too_large( size ) )
+      return NULL;
+
+   n = ( size + granule - 1 ) >> gshift;
+
+   if ( ( f = find_fit( n ) ) == NONE )
+   {
+      size_t last = heap_gran > 0 ? prev_start( heap_gran - 1 ) : 0;
+      size_t have = ( heap_gran > 0 && !TEST( alloc_map, last ) ) ? heap_gran - last : 0;
+
+      if ( ( f = extend_heap( n - have ) ) == NONE )
+         return NULL;
+
+      /* A reclaim callback may have taken the free block that ended the heap */
+      if ( next_start( f + 1 ) - f < n && ( f = extend_heap( n ) ) == NONE )
+         return NULL;
+   }
+
+   place( f, n );
+   return PAYLOAD( f );
+}
+
+
+/*
+ * side_free - free a block, merging it with free neighbours
+ */
+void side_free( void* ptr )
+{
+   size_t f;
+   size_t next;
+
+   if ( ptr == NULL )
+      return;
+
+   f = GRAN_OF( ptr );
+   CLEAR( alloc_map, f );
+
+   next = next_start( f + 1 );
+   if ( !TEST( alloc_map, next ) )
+      CLEAR( start_map, next );
+
+   if ( f > 0 && !TEST( alloc_map, prev_start( f - 1 ) ) )
+      CLEAR( start_map, f );
+}
+
+
+/*
+ * side_usable_size - bytes of payload of the block at ptr
+ */
+size_t side_usable_size( void* ptr )
+{
+   size_t f;
+
+   if ( ptr == NULL )
+      return 0;
+
+   f = GRAN_OF( ptr );
+   return ( next_start( f + 1 ) - f ) << gshift;
+}
+
+
+/*
+ * side_realloc - resize a block, growing it into a free successor when
+ *                that is large enough
+ */
+void* side_realloc( void* ptr, size_t size )
+{
+   size_t oldsize;
+   size_t f;
+   size_t n;
+   size_t next;
+   void*  newptr;
+
+   if ( size == 0 )
+   {
+      side_free( ptr );
+      return NULL;
+   }
+
+   if ( ptr == NULL )
+      return side_malloc( size );
+
+   if ( too_large( size ) )
+      return NULL;
+
+   oldsize = side_usable_size( ptr );
+   if ( size <= oldsize )
+      return ptr;
+
+   f    = GRAN_OF( ptr );
+   n    = ( size + granule - 1 ) >> gshift;
+   next = f + ( oldsize >> gshift );
+
+   if ( !TEST( alloc_map, next ) && next_start( next + 1 ) - f >= n )
+   {
+      CLEAR( start_map, next );
+      if ( next_start( next + 1 ) - f > n )
+         make_block( f + n, 0 );
+      return ptr;
+   }
+
+   if ( ( newptr = side_malloc( size ) ) == NULL )
+      return NULL;
+
+   mem_copy( newptr, ptr, oldsize );
+   side_free( ptr );
+
+   return newptr;
+}
@@ -0,0 +1,34 @@
+/**
+ * @file    side.h
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Allocator with out-of-band metadata: block boundaries in side bitmaps
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The heap holds payloads only, back to back. Which granules start a block
+ * and which of those blocks are allocated is kept in two bitmaps outside
+ * the heap, indexed by the offset from the start of the heap, so an
+ * overrun of a payload cannot corrupt the allocator and a heap walk scans
+ * a dense array instead of the heap itself.
+ *
+ * The granule, 16 bytes by default, is the payload alignment; a granule
+ * of 64 bytes makes every payload cache line aligned.
+ *
+ * mem_init() must be called once before side_init(). The allocator must
+ * be the only user of the memlib heap and regions.
+ */
+#ifndef __2026_10_18_SIDE_H__
+#define __2026_10_18_SIDE_H__
+
+#include <stddef.h>            // size_t
+
+int    side_init( void );
+void   side_set_granule( size_t bytes );
+void*  side_malloc( size_t size );
+void   side_free( void* ptr );
+void*  side_realloc( void* ptr, size_t size );
+size_t side_usable_size( void* ptr );
+
+#endif  // __2026_10_18_SIDE_H__
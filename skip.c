@@ -0,0 +1,455 @@
+/**
+ * @file    skip.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Source file for skip.h
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The heap layout is that of mm.c: blocks with a one word header and
+ * footer, between an allocated prologue block and an epilogue header.
+ * Every free block is also a node of a skip list ordered by address. Its
+ * payload holds the forward links, one per level:
+ *
+ *    | hdr: size | level - 1 | 0 | next[ 0 ] ... next[ level - 1 ] ... | ftr |
+ *
+ * The level, 1 to MAX_LEVEL, is kept in the three header bits between
+ * the allocated bit and the size; it is drawn at random, each further
+ * level with probability 1/4, and capped by the words of the payload.
+ *
+ * Inserting or removing a block finds its predecessor on every level by
+ * descending from the top level of the list head. Coalescing into a free
+ * predecessor only changes the size of that node; a block that takes the
+ * place of another one in address order, such as the remainder of a
+ * split or a block that absorbs its free successor, replaces that node
+ * using a single search. First fit walks level 0 from the lowest address.
+ *
+ * At the heap limit, memlib's purge hook trims a free block at the end of
+ * the heap.
+ */
+#include "skip.h"
+#include "memlib.h"
+
+#include <stdint.h>         // uint64_t
+
+
+// =======================
+// Constants and Macros
+// =======================
+
+#define WSIZE     8                 /* word and header/footer size (bytes) */
+#define DSIZE     16                /* double word size (bytes)            */
+#define CHUNKSIZE ( 1 << 12 )       /* initial heap size (bytes)           */
+#define MAX_LEVEL 8                 /* levels that fit the header bits     */
+
+/* Pack a size and allocated bit into a word */
+#define PACK( size, alloc ) ( ( size ) | ( alloc ) )
+
+/* Read and write a word at address p */
+#define GET( p )        ( *( size_t* )( p ) )
+#define PUT( p, val )   ( *( size_t* )( p ) = ( val ) )
+
+/* Read the size, allocated and level fields from address p */
+#define GET_SIZE( p )   ( GET( p ) & ~( size_t )( DSIZE - 1 ) )
+#define GET_ALLOC( p )  ( GET( p ) & 0x1 )
+#define GET_LEVEL( p )  ( ( int )( ( GET( p ) >> 1 ) & 0x7 ) + 1 )
+#define LEVEL_BITS( l ) ( ( size_t )( ( l ) - 1 ) << 1 )
+
+/* Given block ptr bp, compute address of its header and footer */
+#define HDRP( bp )      ( ( char* )( bp ) - WSIZE )
+#define FTRP( bp )      ( ( char* )( bp ) + GET_SIZE( HDRP( bp ) ) - DSIZE )
+
+/* Given block ptr bp, compute address of next and previous blocks */
+#define NEXT_BLKP( bp ) ( ( char* )( bp ) + GET_SIZE( ( char* )( bp ) - WSIZE ) )
+#define PREV_BLKP( bp ) ( ( char* )( bp ) - GET_SIZE( ( char* )( bp ) - DSIZE ) )
+
+/* Forward link i of free block bp */
+#define NEXT( bp, i )   ( ( ( char** )( bp ) )[ i ] )
+
+
+// ==========================
+// Private Global Variables
+// ==========================
+
+static char*    heap_listp = NULL;       /* Pointer to the prologue block     */
+static char*    head[ MAX_LEVEL ];       /* first free block on every level   */
+static uint64_t seed;                    /* xorshift state for the levels     */
+
+
+// ==========================
+// Private Helper Functions
+// ==========================
+
+/*
+ * too_large - whether a request of size bytes would overflow the rounding
+ *             to blocks or pages; no such request can be met anyway
+ */
+static int too_large( size_t size )
+{
+   return size > ( size_t )-1 - DSIZE - mem_pagesize();
+}
+
+
+/*
+ * adjust_size - block size needed for a payload of size bytes
+ */
+static size_t adjust_size( size_t size )
+{
+   if ( size <= DSIZE )
+      return 2 * DSIZE;
+
+   return DSIZE * ( ( size + DSIZE + ( DSIZE - 1 ) ) / DSIZE );
+}
+
+
+/*
+ * random_level - level of a new node of a free block of size bytes
+ */
+static int random_level( size_t size )
+{
+   size_t   cap   = ( size - DSIZE ) / WSIZE;
+   uint64_t bits;
+   int      level = 1;
+
+   seed ^= seed << 13;
+   seed ^= seed >> 7;
+   seed ^= seed << 17;
+
+   if ( cap > MAX_LEVEL )
+      cap = MAX_LEVEL;
+
+   for ( bits = seed; ( size_t )level < cap && ( bits & 3 ) == 0; bits >>= 2 )
+      ++level;
+
+   return level;
+}
+
+
+/*
+ * link_of - the level i link that follows x, or the head's for x == NULL
+ */
+static char** link_of( char* x, int i )
+{
+   return x != NULL ? &NEXT( x, i ) : &head[ i ];
+}
+
+
+/*
+ * find_preds - the last free block before address bp on every level, or
+ *              NULL where that is the list head
+ */
+static void find_preds( char* bp, char** update )
+{
+   char* x = NULL;
+   char* next;
+   int   i;
+
+   for ( i = MAX_LEVEL - 1; i >= 0; --i )
+   {
+      while ( ( next = *link_of( x, i ) ) != NULL && next < bp )
+         x = next;
+      update[ i ] = x;
+   }
+}
+
+
+/*
+ * insert_block - make bp a free block of size bytes and add it to the list
+ */
+static void insert_block( char* bp, size_t size )
+{
+   char* update[ MAX_LEVEL ];
+   int   level = random_level( size );
+   int   i;
+
+   PUT( HDRP( bp ), PACK( size, 0 ) | LEVEL_BITS( level ) );
+   PUT( FTRP( bp ), PACK( size, 0 ) );
+
+   find_preds( bp, update );
+   for ( i = 0; i < level; ++i )
+   {
+      NEXT( bp, i )              = *link_of( update[ i ], i );
+      *link_of( update[ i ], i ) = bp;
+   }
+}
+
+
+/*
+ * remove_block - take free block bp off the list
+ */
+static void remove_block( char* bp )
+{
+   char* update[ MAX_LEVEL ];
+   int   level = GET_LEVEL( HDRP( bp ) );
+   int   i;
+
+   find_preds( bp, update );
+   for ( i = 0; i < level; ++i )
+      *link_of( update[ i ], i ) = NEXT( bp, i );
+}
+
+
+/*
+ * replace_block - put a free block of size bytes at bp in the place of free
+ *                 block old; no other free block may lie between the two
+ *
+ * The links of old are saved first, since the new block may overlap them.
+ */
+static void replace_block( char* old, char* bp, size_t size )
+{
+   char* update[ MAX_LEVEL ];
+   char* next[ MAX_LEVEL ];
+   int   old_level = GET_LEVEL( HDRP( old ) );
+   int   level     = random_level( size );
+   int   i;
+
+   find_preds( old, update );
+   for ( i = 0; i < MAX_LEVEL; ++i )
+      next[ i ] = i < old_level ? NEXT( old, i ) : *link_of( update[ i ], i );
+
+   PUT( HDRP( bp ), PACK( size, 0 ) | LEVEL_BITS( level ) );
+   PUT( FTRP( bp ), PACK( size, 0 ) );
+
+   for ( i = 0; i < MAX_LEVEL; ++i )
+   {
+      if ( i < level )
+      {
+         NEXT( bp, i )              = next[ i ];
+         *link_of( update[ i ], i ) = bp;
+      }
+      else if ( i < old_level )
+      {
+         *link_of( update[ i ], i ) = next[ i ];
+      }
+   }
+}
+
+
+/*
+ * coalesce - merge free block bp, not yet on the list, with its free
+ *            neighbours and list the result
+ */
+static void* coalesce( void* bp )
+{
+   char*  prev       = PREV_BLKP( bp );
+   char*  next       = NEXT_BLKP( bp );
+   size_t prev_alloc = GET_ALLOC( FTRP( prev ) );
+   size_t next_alloc = GET_ALLOC( HDRP( next ) );
+   size_t size       = GET_SIZE( HDRP( bp ) );
+
+   if ( prev_alloc && next_alloc )                /* Case 1 */
+   {
+      insert_block( bp, size );
+      return bp;
+   }
+
+   if ( prev_alloc && !next_alloc )               /* Case 2 */
+   {
+      replace_block( next, bp, size + GET_SIZE( HDRP( next ) ) );
+      return bp;
+   }
+
+   /* Cases 3 and 4: the free predecessor keeps its node and grows */
+   if ( !next_alloc )
+   {
+      remove_block( next );
+      size += GET_SIZE( HDRP( next ) );
+   }
+
+   size += GET_SIZE( HDRP( prev ) );
+   PUT( HDRP( prev ), PACK( size, 0 ) | ( GET( HDRP( prev ) ) & LEVEL_BITS( MAX_LEVEL ) ) );
+   PUT( FTRP( prev ), PACK( size, 0 ) );
+   return prev;
+}
+
+
+/*
+ * extend_heap - extend the heap with a free block of at least words words
+ *               and return its block pointer
+ */
+static void* extend_heap( size_t words )
+{
+   char*  bp;
+   size_t size;
+
+   size = ( words % 2 ) ? ( words + 1 ) * WSIZE : words * WSIZE;
+
+   if ( ( long )( bp = mem_grow( size, &size ) ) == -1 )
+      return NULL;
+
+   PUT( HDRP( bp ), PACK( size, 0 ) );            /* Free block header   */
+   PUT( FTRP( bp ), PACK( size, 0 ) );            /* Free block footer   */
+   PUT( HDRP( NEXT_BLKP( bp ) ), PACK( 0, 1 ) );  /* New epilogue header */
+
+   return coalesce( bp );
+}
+
+
+/*
+ * find_fit - first fit in address order: walk level 0 of the list
+ */
+static void* find_fit( size_t asize )
+{
+   char* bp;
+
+   for ( bp = head[ 0 ]; bp != NULL; bp = NEXT( bp, 0 ) )
+   {
+      if ( asize <= GET_SIZE( HDRP( bp ) ) )
+         return bp;
+   }
+
+   return NULL;    /* No fit */
+}
+
+
+/*
+ * place - place block of asize bytes at start of free block bp and split
+ *         if remainder would be at least minimum block size
+ */
+static void place( void* bp, size_t asize )
+{
+   size_t csize = GET_SIZE( HDRP( bp ) );
+
+   if ( ( csize - asize ) >= ( 2 * DSIZE ) )
+   {
+      /* The remainder takes the place of bp in the list */
+      replace_block( bp, ( char* )bp + asize, csize - asize );
+      PUT( HDRP( bp ), PACK( asize, 1 ) );
+      PUT( FTRP( bp ), PACK( asize, 1 ) );
+   }
+   else
+   {
+      remove_block( bp );
+      PUT( HDRP( bp ), PACK( csize, 1 ) );
+      PUT( FTRP( bp ), PACK( csize, 1 ) );
+   }
+}
+
+
+/*
+ * purge - memlib purge hook: trim the whole free block at the end of the heap
+ */
+static void purge( void )
+{
+   char*  brk  = ( char* )mem_heap_hi() + 1;
+   size_t size = GET_SIZE( brk - DSIZE );         /* footer of the last block */
+   char*  bp   = brk - size;
+
+   if ( GET_ALLOC( brk - DSIZE ) )
+      return;
+
+   remove_block( bp );
+   if ( mem_trim( size ) == 0 )
+      PUT( HDRP( bp ), PACK( 0, 1 ) );            /* New epilogue header */
+   else
+      insert_block( bp, size );
+}
+
+
+// ==========================
+// Public Functions
+// ==========================
+
+/*
+ * skip_init - initialize the allocator with an empty heap
+ *
+ * Return: 0 on success, -1 if the initial heap could not be created
+ */
+int skip_init( void )
+{
+   int i;
+
+   if ( ( heap_listp = mem_sbrk( 4 * WSIZE ) ) == ( void* )-1 )
+      return -1;
+
+   PUT( heap_listp, 0 );                              /* Alignment padding */
+   PUT( heap_listp + ( 1 * WSIZE ), PACK( DSIZE, 1 ) ); /* Prologue header   */
+   PUT( heap_listp + ( 2 * WSIZE ), PACK( DSIZE, 1 ) ); /* Prologue footer   */
+   PUT( heap_listp + ( 3 * WSIZE ), PACK( 0, 1 ) );     /* Epilogue header   */
+   heap_listp += ( 2 * WSIZE );
+
+   for ( i = 0; i < MAX_LEVEL; ++i )
+      head[ i ] = NULL;
+   seed = 0x9e3779b97f4a7c15ULL;       /* the same levels on every run */
+
+   mem_set_purge( purge );
+
+   if ( extend_heap( CHUNKSIZE / WSIZE ) == NULL )
+      return -1;
+
+   return 0;
+}
+
+
+/*
+ * skip_malloc - allocate a block with at least size bytes of payload
+ */
+void* skip_malloc( size_t size )
+{
+   size_t asize;
+   char*  bp;
+
+   if ( size == 0 || too_large( size ) )
+      return NULL;
+
+   asize = adjust_size( size );
+
+   if ( ( bp = find_fit( asize ) ) == NULL && ( bp = extend_heap( asize / WSIZE ) ) == NULL )
+      return NULL;
+
+   place( bp, asize );
+   return bp;
+}
+
+
+/*
+ * skip_free - free a block
+ */
+void skip_free( void* bp )
+{
+   size_t size;
+
+   if ( bp == NULL )
+      return;
+
+   size = GET_SIZE( HDRP( bp ) );
+
+   PUT( HDRP( bp ), PACK( size, 0 ) );
+   PUT( FTRP( bp ), PACK( size, 0 ) );
+   coalesce( bp );
+}
+
+
+/*
+ * skip_realloc - resize a block, keeping it in place when it is already large enough
+ */
+void* skip_realloc( void* ptr, size_t size )
+{
+   size_t oldsize;
+   void*  newptr;
+
+   if ( size == 0 )
+   {
+      skip_free( ptr );
+      return NULL;
+   }
+
+   if ( ptr == NULL )
+      return skip_malloc( size );
+
+   if ( too_large( size ) )
+      return NULL;
+
+   oldsize = GET_SIZE( HDRP( ptr ) ) - DSIZE;
+   if ( size <= oldsize )
+      return ptr;
+
+   if ( ( newptr = skip_malloc( size ) ) == NULL )
+      return NULL;
+
+   mem_copy( newptr, ptr, oldsize );
+   skip_free( ptr );
+
+   return newptr;
+}
@@ -0,0 +1,28 @@
+/**
+ * @file    skip.h
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Address-ordered first-fit allocator with a skip list of free blocks
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Free blocks are kept in address order, which gives first fit the low
+ * fragmentation of address-ordered placement, in a skip list, so that a
+ * block is inserted into or removed from the list in O(log n) expected
+ * time instead of walking the list to its position.
+ *
+ * mem_init() must be called once before skip_init(). The allocator must
+ * be the only user of the memlib heap.
+ */
+#ifndef __2026_10_18_SKIP_H__
+#define __2026_10_18_SKIP_H__
+
+#include <stddef.h>            // size_t
+
+int   skip_init( void );
+void* skip_malloc( size_t size );
+void  skip_free( void* ptr );
+void* skip_realloc( void* ptr, size_t size );
+
+#endif  // __2026_10_18_SKIP_H__
@@ -0,0 +1,516 @@
+/**
+ * @file    slab.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Source file for slab.h
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Every slab is one page, aligned to the page size, so the slab of an
+ * object is found by rounding its address down. The page starts with a
+ * cache line sized header; the objects follow, after the color offset:
+ *
+ *    | header | color | object ... object | slack - color |
+ *
+ * The slack of a page is what is left after the header and the objects.
+ * With coloring on, the color of each new slab of a class is the next
+ * multiple of CACHE_LINE within the slack, wrapping around, as in
+ * Bonwick's slab allocator.
+ *
+ * A slab with free objects is on the partial list of its class. A slab
+ * whose objects are all free is freed as a one-page run, unless it is the
+ * only partial slab of its class. Requests larger than the largest class
+ * get a run of pages with the header in front. Free runs are kept in
+ * address order and merged with their neighbours; they are reused first
+ * fit, for slabs as well as large blocks, and split when larger than
+ * needed. A free run that ends where the unused pages from memlib begin
+ * is merged into those.
+ *
+ * Pages come from memlib through mem_grow, so the allocator must be the
+ * only user of the heap. At the heap limit, memlib's purge hook frees the
+ * empty slabs and trims the unused pages off the end of the heap, except
+ * while the heap is growing for a run: those pages are part of the run.
+ */
+#include "slab.h"
+#include "memlib.h"
+
+#include <stdint.h>         // uintptr_t
+
+
+// =======================
+// Constants and Macros
+// =======================
+
+#define CACHE_LINE 64
+#define SLAB_HDR   64            /* header size: one cache line */
+#define ALIGNMENT  16
+#define NCLASSES   ( int )( sizeof( class_size ) / sizeof( class_size[ 0 ] ) )
+#define MAX_SMALL  2016          /* two objects per 4 KB page   */
+
+#define PAGE_OF( p ) ( ( slab_t* )( ( uintptr_t )( p ) & ~( ( uintptr_t )pagesize - 1 ) ) )
+
+
+// =======================
+// Types
+// =======================
+
+typedef struct slab slab_t;
+
+struct slab
+{
+   slab_t* next;     /* partial list of the class, or free page or run list */
+   slab_t* prev;
+   void*   free;     /* free objects of a small slab                        */
+   size_t  pages;    /* pages of a large run; 0 for a small slab            */
+   int     cls;
+   int     inuse;    /* allocated objects of a small slab                   */
+};
+
+
+// ==========================
+// Private Global Variables
+// ==========================
+
+/* Size classes: multiples of 16 up to 128, then four per power of two,
+   with the last two filling a 4 KB page exactly */
+static const size_t class_size[] =
+{
+   16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512,
+   640, 768, 896, 1024, 1344, MAX_SMALL
+};
+
+static unsigned char class_index[ MAX_SMALL / ALIGNMENT + 1 ];   /* by size / 16 */
+
+static size_t   pagesize;
+static int      coloring = 1;
+static slab_t*  partial[ NCLASSES ];
+static unsigned next_color[ NCLASSES ];
+static slab_t*  free_runs;       /* free page runs, by address   */
+static char*    carve_lo;        /* pages from memlib not yet used */
+static char*    carve_hi;
+static int      growing;         /* inside get_pages: purge keeps the unused pages */
+
+
+// ==========================
+// Private Helper Functions
+// ==========================
+
+static void link_partial( slab_t* s )
+{
+   s->prev = NULL;
+   s->next = partial[ s->cls ];
+   if ( s->next != NULL )
+      s->next->prev = s;
+   partial[ s->cls ] = s;
+}
+
+
+static void unlink_partial( slab_t* s )
+{
+   if ( s->prev != NULL )
+      s->prev->next = s->next;
+   else
+      partial[ s->cls ] = s->next;
+
+   if ( s->next != NULL )
+      s->next->prev = s->prev;
+}
+
+
+/*
+ * too_large - whether a request of size bytes would overflow the rounding
+ *             to pages; no such request can be met anyway
+ */
+static int too_large( size_t size )
+{
+   return size > ( size_t )-1 - SLAB_HDR - pagesize;
+}
+
+
+/*
+ * grow_carve - grow the heap by at least bytes and add them to the carve range
+ *
+ * Return: 0 on success, -1 if memlib is full
+ */
+static int grow_carve( size_t bytes )
+{
+   size_t got;
+   char*  p;
+
+   if ( ( p = mem_grow( bytes, &got ) ) == ( void* )-1 )
+      return -1;
+
+   if ( p != carve_hi )            /* not contiguous: drop the remainder */
+      carve_lo = p;
+   carve_hi = p + got;
+   return 0;
+}
+
+
+/*
+ * get_pages - n fresh pages from memlib, or NULL
+ *
+ * At the heap limit the purge hook can merge freed runs into the unused
+ * pages while the heap grows; a growth that failed is then tried again
+ * with the smaller shortfall.
+ */
+static void* get_pages( size_t n )
+{
+   size_t need = n * pagesize;
+   size_t have;
+   char*  p;
+
+   growing = 1;
+   while ( ( have = ( size_t )( carve_hi - carve_lo ) ) < need )
+   {
+      if ( grow_carve( need - have ) < 0 && ( size_t )( carve_hi - carve_lo ) == have )
+         break;
+   }
+   growing = 0;
+
+   if ( have < need )
+      return NULL;
+
+   p         = carve_lo;
+   carve_lo += need;
+   return p;
+}
+
+
+/*
+ * find_run - the first free run of at least n pages, cut to n pages, or NULL
+ */
+static slab_t* find_run( size_t n )
+{
+   slab_t** link;
+   slab_t*  run;
+
+   for ( link = &free_runs; *link != NULL; link = &( *link )->next )
+   {
+      run = *link;
+      if ( run->pages < n )
+         continue;
+
+      /* Leave the pages beyond the request in the list as a smaller run */
+      if ( run->pages > n )
+      {
+         slab_t* rest = ( slab_t* )( ( char* )run + n * pagesize );
+
+         rest->pages = run->pages - n;
+         rest->next  = run->next;
+         *link       = rest;
+      }
+      else
+      {
+         *link = run->next;
+      }
+
+      run->pages = n;
+      return run;
+   }
+
+   return NULL;
+}
+
+
+/*
+ * take_run - a run of n pages, from the free runs or fresh from memlib, or NULL
+ */
+static slab_t* take_run( size_t n )
+{
+   slab_t* run;
+
+   if ( ( run = find_run( n ) ) != NULL )
+      return run;
+
+   if ( ( run = get_pages( n ) ) != NULL )
+   {
+      run->pages = n;
+      return run;
+   }
+
+   /* The purge hook may have freed runs while the heap failed to grow */
+   return find_run( n );
+}
+
+
+/*
+ * free_run - return a run of pages, merging it with adjacent free runs
+ */
+static void free_run( slab_t* run )
+{
+   slab_t** link = &free_runs;
+   slab_t*  prev = NULL;
+
+   while ( *link != NULL && *link < run )
+   {
+      prev = *link;
+      link = &( *link )->next;
+   }
+
+   run->next = *link;
+   *link     = run;
+
+   if ( run->next != NULL && ( char* )run + run->pages * pagesize == ( char* )run->next )
+   {
+      run->pages += run->next->pages;
+      run->next   = run->next->next;
+   }
+
+   if ( prev != NULL && ( char* )prev + prev->pages * pagesize == ( char* )run )
+   {
+      prev->pages += run->pages;
+      prev->next   = run->next;
+      run          = prev;
+   }
+
+   /* The last run goes back to the unused pages */
+   if ( run->next == NULL && ( char* )run + run->pages * pagesize == carve_lo )
+   {
+      carve_lo = ( char* )run;
+
+      for ( link = &free_runs; *link != run; link = &( *link )->next )
+         ;
+      *link = NULL;
+   }
+}
+
+
+/*
+ * new_slab - make a slab of class c and put it on the partial list
+ */
+static slab_t* new_slab( int c )
+{
+   size_t  size = class_size[ c ];
+   size_t  n    = ( pagesize - SLAB_HDR ) / size;
+   size_t  slack;
+   size_t  color = 0;
+   slab_t* s;
+   char*   obj;
+   size_t  i;
+
+   if ( ( s = take_run( 1 ) ) == NULL )
+      return NULL;
+
+   if ( coloring )
+   {
+      slack = pagesize - SLAB_HDR - n * size;
+      color = ( next_color[ c ]++ % ( slack / CACHE_LINE + 1 ) ) * CACHE_LINE;
+   }
+
+   s->pages = 0;
+   s->cls   = c;
+   s->inuse = 0;
+   s->free  = NULL;
+
+   /* Thread the objects onto the free list, lowest address first */
+   obj = ( char* )s + SLAB_HDR + color + ( n - 1 ) * size;
+   for ( i = 0; i < n; ++i, obj -= size )
+   {
+      *( void** )obj = s->free;
+      s->free        = obj;
+   }
+
+   link_partial( s );
+   return s;
+}
+
+
+/*
+ * usable_size - bytes of payload of the block at ptr
+ */
+static size_t usable_size( void* ptr )
+{
+   slab_t* s = PAGE_OF( ptr );
+
+   return s->pages ? s->pages * pagesize - SLAB_HDR : class_size[ s->cls ];
+}
+
+
+/*
+ * purge - memlib purge hook: free the empty slabs kept for each class and
+ *         give the unused pages at the end of the heap back
+ */
+static void purge( void )
+{
+   int c;
+
+   for ( c = 0; c < NCLASSES; ++c )
+   {
+      slab_t* s = partial[ c ];
+
+      while ( s != NULL )
+      {
+         slab_t* next = s->next;
+
+         if ( s->inuse == 0 )
+         {
+            unlink_partial( s );
+            s->pages = 1;
+            free_run( s );
+         }
+         s = next;
+      }
+   }
+
+   if ( !growing && carve_hi > carve_lo && carve_hi == ( char* )mem_heap_hi() + 1
+        && mem_trim( carve_hi - carve_lo ) == 0 )
+      carve_hi = carve_lo;
+}
+
+
+// ==========================
+// Public Functions
+// ==========================
+
+/*
+ * slab_init - start over with no slabs, on a page aligned brk
+ *
+ * Return: 0 on success, -1 if the page size is too small or memlib is full
+ */
+int slab_init( void )
+{
+   size_t pad;
+   int    c;
+   int    i;
+
+   pagesize = mem_pagesize();
+   if ( pagesize < SLAB_HDR + 2 * MAX_SMALL )
+      return -1;
+
+   for ( c = 0, i = 0; i <= MAX_SMALL / ALIGNMENT; ++i )
+   {
+      while ( class_size[ c ] < ( size_t )i * ALIGNMENT )
+         ++c;
+      class_index[ i ] = ( unsigned char )c;
+   }
+
+   for ( c = 0; c < NCLASSES; ++c )
+   {
+      partial[ c ]    = NULL;
+      next_color[ c ] = 0;
+   }
+   free_runs = NULL;
+
+   pad = ( pagesize - mem_heapsize() % pagesize ) % pagesize;
+   if ( pad > 0 && mem_sbrk( ( int )pad ) == ( void* )-1 )
+      return -1;
+
+   carve_lo = ( char* )mem_heap_hi() + 1;
+   carve_hi = carve_lo;
+
+   mem_set_purge( purge );
+   return 0;
+}
+
+
+/*
+ * slab_set_coloring - turn cache coloring of new slabs on or off
+ */
+void slab_set_coloring( int on )
+{
+   coloring = on;
+}
+
+
+/*
+ * slab_malloc - allocate a block with at least size bytes of payload
+ */
+void* slab_malloc( size_t size )
+{
+   slab_t* s;
+   void*   obj;
+   int     c;
+
+   if ( size == 0 || too_large( size ) )
+      return NULL;
+
+   if ( size > MAX_SMALL )
+   {
+      if ( ( s = take_run( ( size + SLAB_HDR + pagesize - 1 ) / pagesize ) ) == NULL )
+         return NULL;
+      return ( char* )s + SLAB_HDR;
+   }
+
+   c = class_index[ ( size + ALIGNMENT - 1 ) / ALIGNMENT ];
+   if ( ( s = partial[ c ] ) == NULL && ( s = new_slab( c ) ) == NULL )
+      return NULL;
+
+   obj     = s->free;
+   s->free = *( void** )obj;
+   ++s->inuse;
+
+   if ( s->free == NULL )
+      unlink_partial( s );
+
+   return obj;
+}
+
+
+/*
+ * slab_free - free a block
+ */
+void slab_free( void* ptr )
+{
+   slab_t* s;
+
+   if ( ptr == NULL )
+      return;
+
+   s = PAGE_OF( ptr );
+
+   if ( s->pages > 0 )
+   {
+      free_run( s );
+      return;
+   }
+
+   if ( s->free == NULL )          /* was full */
+      link_partial( s );
+
+   *( void** )ptr = s->free;
+   s->free        = ptr;
+
+   /* Keep one empty slab per class; the others become free pages */
+   if ( --s->inuse == 0 && ( s->prev != NULL || s->next != NULL ) )
+   {
+      unlink_partial( s );
+      s->pages = 1;
+      free_run( s );
+   }
+}
+
+
+/*
+ * slab_realloc - resize a block, keeping it in place when it is already large enough
+ */
+void* slab_realloc( void* ptr, size_t size )
+{
+   size_t oldsize;
+   void*  newptr;
+
+   if ( size == 0 )
+   {
+      slab_free( ptr );
+      return NULL;
+   }
+
+   if ( ptr == NULL )
+      return slab_malloc( size );
+
+   if ( too_large( size ) )
+      return NULL;
+
+   oldsize = usable_size( ptr );
+   if ( size <= oldsize )
+      return ptr;
+
+   if ( ( newptr = slab_malloc( size ) ) == NULL )
+      return NULL;
+
+   mem_copy( newptr, ptr, oldsize );
+   slab_free( ptr );
+
+   return newptr;
+}
@@ -0,0 +1,30 @@
+/**
+ * @file    slab.h
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Slab allocator with cache coloring, built on top of memlib
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Small requests are served from one-page slabs of equal-sized objects,
+ * one list of slabs per size class; larger requests get a run of whole
+ * pages. With coloring on, consecutive slabs of a class start their first
+ * object at different cache line offsets within the slack of the page, so
+ * the same object of different slabs does not map to the same cache set.
+ *
+ * mem_init() must be called once before slab_init(). The slab allocator
+ * must be the only user of the memlib heap.
+ */
+#ifndef __2026_10_18_SLAB_H__
+#define __2026_10_18_SLAB_H__
+
+#include <stddef.h>            // size_t
+
+int   slab_init( void );
+void  slab_set_coloring( int on );
+void* slab_malloc( size_t size );
+void  slab_free( void* ptr );
+void* slab_realloc( void* ptr, size_t size );
+
+#endif  // __2026_10_18_SLAB_H__
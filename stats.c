@@ -0,0 +1,167 @@
+/**
+ * @file    stats.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Source file for stats.h
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include "stats.h"
+#include "std_wrappers.h"
+
+#include <math.h>           // fabs, sqrt
+#include <stdlib.h>         // free, qsort
+#include <string.h>         // memcpy
+
+
+// ==========================
+// Private Helper Functions
+// ==========================
+
+static int compare_doubles( const void* a, const void* b )
+{
+   double x = *( const double* )a;
+   double y = *( const double* )b;
+
+   return ( x > y ) - ( x < y );
+}
+
+
+// ==========================
+// Public Functions
+// ==========================
+
+/*
+ * stats_sort - sort samples in ascending order
+ */
+void stats_sort( double* samples, int n )
+{
+   qsort( samples, n, sizeof( double ), compare_doubles );
+}
+
+
+/*
+ * stats_percentile - p-th percentile (0 <= p <= 100) of sorted samples,
+ *                    linearly interpolated between closest ranks
+ */
+double stats_percentile( const double* sorted, int n, double p )
+{
+   double rank;
+   int    lo;
+
+   if ( n <= 0 )
+      return 0.0;
+
+   rank = p / 100.0 * ( n - 1 );
+   lo   = ( int )rank;
+
+   if ( lo >= n - 1 )
+      return sorted[ n - 1 ];
+
+   return sorted[ lo ] + ( rank - lo ) * ( sorted[ lo + 1 ] - sorted[ lo ] );
+}
+
+
+/*
+ * stats_t95 - two-sided 95% critical value of Student's t with df degrees of freedom
+ */
+double stats_t95( int df )
+{
+   static const double table[] =
+   {
+      0.0,   12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+             2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+             2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+   };
+
+   if ( df <= 0 )
+      return 0.0;
+   if ( df < ( int )( sizeof( table ) / sizeof( table[ 0 ] ) ) )
+      return table[ df ];
+   if ( df < 60 )
+      return 2.021;
+   if ( df < 120 )
+      return 2.000;
+
+   return 1.960;
+}
+
+
+/*
+ * stats_summarize - mean, median, spread and 95% confidence interval of the mean
+ */
+void stats_summarize( const double* samples, int n, stats_summary_t* s )
+{
+   double* sorted;
+   double  sum = 0.0;
+   double  sq  = 0.0;
+   int     i;
+
+   s->n = n;
+   s->mean = s->median = s->stddev = s->ci95 = s->min = s->max = 0.0;
+
+   if ( n <= 0 )
+      return;
+
+   sorted = ( double* )Malloc( n * sizeof( double ) );
+   memcpy( sorted, samples, n * sizeof( double ) );
+   stats_sort( sorted, n );
+
+   for ( i = 0; i < n; ++i )
+      sum += sorted[ i ];
+   s->mean = sum / n;
+
+   for ( i = 0; i < n; ++i )
+      sq += ( sorted[ i ] - s->mean ) * ( sorted[ i ] - s->mean );
+
+   s->median = stats_percentile( sorted, n, 50.0 );
+   s->min    = sorted[ 0 ];
+   s->max    = sorted[ n - 1 ];
+
+   if ( n > 1 )
+   {
+      s->stddev = sqrt( sq / ( n - 1 ) );
+      s->ci95   = stats_t95( n - 1 ) * s->stddev / sqrt( ( double )n );
+   }
+
+   free( sorted );
+}
+
+
+/*
+ * stats_welch - Welch's unequal variances t-test of the means of a and b
+ *
+ * t receives the t statistic of mean( b ) - mean( a ).
+ *
+ * Return: 1 if the means differ at the 95% level (two-sided), 0 otherwise
+ */
+int stats_welch( const double* a, int na, const double* b, int nb, double* t )
+{
+   stats_summary_t sa;
+   stats_summary_t sb;
+   double          va;
+   double          vb;
+   double          df;
+
+   *t = 0.0;
+
+   if ( na < 2 || nb < 2 )
+      return 0;
+
+   stats_summarize( a, na, &sa );
+   stats_summarize( b, nb, &sb );
+
+   va = sa.stddev * sa.stddev / na;
+   vb = sb.stddev * sb.stddev / nb;
+
+   if ( va + vb == 0.0 )                   /* identical constant samples */
+      return sa.mean != sb.mean;
+
+   *t = ( sb.mean - sa.mean ) / sqrt( va + vb );
+
+   /* Welch-Satterthwaite degrees of freedom */
+   df = ( va + vb ) * ( va + vb ) / ( va * va / ( na - 1 ) + vb * vb / ( nb - 1 ) );
+
+   return fabs( *t ) > stats_t95( ( int )df );
+}
\ No newline at end of file
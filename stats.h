@@ -0,0 +1,33 @@
+/**
+ * @file    stats.h
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Summary statistics for repeated benchmark measurements
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Confidence intervals use Student's t distribution, which is the right
+ * choice for the handful of repetitions a benchmark can afford.
+ */
+#ifndef __2026_10_18_STATS_H__
+#define __2026_10_18_STATS_H__
+
+typedef struct
+{
+   int    n;         /* number of samples                              */
+   double mean;
+   double median;
+   double stddev;    /* sample standard deviation (n - 1)              */
+   double ci95;      /* half-width of the 95% confidence interval      */
+   double min;
+   double max;
+} stats_summary_t;
+
+void   stats_sort( double* samples, int n );
+double stats_percentile( const double* sorted, int n, double p );
+double stats_t95( int df );
+void   stats_summarize( const double* samples, int n, stats_summary_t* s );
+int    stats_welch( const double* a, int na, const double* b, int nb, double* t );
+
+#endif  // __2026_10_18_STATS_H__
@@ -17,6 +17,8 @@
 #include <stdio.h>          // fprintf, stderr
 #include <string.h>         // strerror
 
+#include <sys/mman.h>       // mmap, munmap, MAP_FAILED
+
 void* Malloc( size_t size )
 {
    void* ptr;
@@ -28,6 +30,93 @@ void* Malloc( size_t size )
 }
 
 
+void* Calloc( size_t nmemb, size_t size )
+{
+   void* ptr;
+
+   if ( ( ptr = calloc( nmemb, size ) ) == NULL )
+      unix_error( "Calloc Error" );
+
+   return ptr;
+}
+
+
+void* Realloc( void* ptr, size_t size )
+{
+   if ( ( ptr = realloc( ptr, size ) ) == NULL )
+      unix_error( "Realloc Error" );
+
+   return ptr;
+}
+
+
+FILE* Fopen( const char* filename, const char* mode )
+{
+   FILE* fp;
+
+   if ( ( fp = fopen( filename, mode ) ) == NULL )
+      unix_error( "Fopen Error" );
+
+   return fp;
+}
+
+
+void Fclose( FILE* fp )
+{
+   if ( fclose( fp ) != 0 )
+      unix_error( "Fclose Error" );
+}
+
+
+void* Mmap( void* addr, size_t len, int prot, int flags, int fd, long offset )
+{
+   void* ptr;
+
+   if ( ( ptr = mmap( addr, len, prot, flags, fd, offset ) ) == MAP_FAILED )
+      unix_error( "mmap error" );
+
+   return ptr;
+}
+
+
+void Munmap( void* start, size_t length )
+{
+   if ( munmap( start, length ) < 0 )
+      unix_error( "munmap error" );
+}
+
+
+// ==============================
+// Pthreads Wrappers
+// ==============================
+
+void Pthread_create( pthread_t* tidp, pthread_attr_t* attrp, void* ( *routine )( void* ), void* argp )
+{
+   int rc;
+
+   if ( ( rc = pthread_create( tidp, attrp, routine, argp ) ) != 0 )
+      posix_error( rc, "Pthread_create error" );
+}
+
+
+void Pthread_join( pthread_t tid, void** thread_return )
+{
+   int rc;
+
+   if ( ( rc = pthread_join( tid, thread_return ) ) != 0 )
+      posix_error( rc, "Pthread_join error" );
+}
+
+
+void Pthread_detach( pthread_t tid )
+{
+   int rc;
+
+   if ( ( rc = pthread_detach( tid ) ) != 0 )
+      posix_error( rc, "Pthread_detach error" );
+}
+
+
 // ==============================
 // Error Handling Functions
 // ==============================
@@ -37,4 +126,20 @@ void unix_error( char* msg )
 {
    fprintf( stderr, "%s: %s\n", msg, strerror( errno ) );
    exit( EXIT_FAILURE );
+}
+
+
+// Posix-style error
+void posix_error( int code, char* msg )
+{
+   fprintf( stderr, "%s: %s\n", msg, strerror( code ) );
+   exit( EXIT_FAILURE );
+}
+
+
+// Application error
+void app_error( char* msg )
+{
+   fprintf( stderr, "%s\n", msg );
+   exit( EXIT_FAILURE );
 }
\ No newline at end of file
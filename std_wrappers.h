@@ -13,9 +13,27 @@
 #define __2025_04_15_STD_WRAPPERS_H
 
 #include <stddef.h>       // size_t
+#include <stdio.h>        // FILE
+
+#include <pthread.h>      // pthread_t, pthread_attr_t
 
 void* Malloc( size_t size );
+void* Calloc( size_t nmemb, size_t size );
+void* Realloc( void* ptr, size_t size );
+
+FILE* Fopen( const char* filename, const char* mode );
+void  Fclose( FILE* fp );
+
+void* Mmap( void* addr, size_t len, int prot, int flags, int fd, long offset );
+void  Munmap( void* start, size_t length );
+
+void  Pthread_create( pthread_t* tidp, pthread_attr_t* attrp, void* ( *routine )( void* ), void* argp );
+void  Pthread_join( pthread_t tid, void** thread_return );
+void  Pthread_detach( pthread_t tid );
+
+void  posix_error( int code, char* msg );
 
 void  unix_error( char* msg );
+void  app_error( char* msg );
 
 #endif  // __2025_04_15_STD_WRAPPERS_H
\ No newline at end of file
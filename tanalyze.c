@@ -0,0 +1,393 @@
+/**
+ * @file    tanalyze.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Trace analyzer: workload statistics for allocator trace files
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Reads one or more trace files (see trace.h) and reports, for each:
+ *
+ *    - request size histograms for allocs and reallocs
+ *    - object lifetimes, measured both in requests and in bytes allocated
+ *      between the birth and the death of an object
+ *    - peak live payload bytes and the request at which it occurs
+ *    - realloc chains: how many times an object is resized before it dies
+ *    - cross-thread frees: frees issued by a thread other than the one
+ *      that (re)allocated the block
+ *    - the theoretical best utilization: peak live payload divided by the
+ *      peak sum of block sizes an ideal allocator with the given alignment
+ *      and per-block overhead, but no fragmentation, would need
+ *
+ * No allocator is run; the numbers describe the workload alone.
+ *
+ * usage: tanalyze [-h] [-a <align>] [-o <overhead>] <tracefile>...
+ */
+#include "trace.h"
+#include "std_wrappers.h"
+
+#include <stdio.h>          // printf, fprintf, stderr
+#include <stdlib.h>         // atoi, exit, free, EXIT_SUCCESS, EXIT_FAILURE
+#include <string.h>         // memset
+
+#include <unistd.h>         // getopt, optarg, optind
+
+
+// =======================
+// Constants and Macros
+// =======================
+
+#define NBUCKETS     34     /* log2 buckets: 0, 1, 2-3, 4-7, ... 2^32+    */
+#define BAR_WIDTH    40     /* width of the widest histogram bar          */
+
+#define DEFAULT_ALIGN    16 /* payload alignment of the modelled allocator   */
+#define DEFAULT_OVERHEAD 16 /* per-block header and footer bytes            */
+
+#define ALIGN_UP( size, align ) ( ( ( size ) + ( ( align ) - 1 ) ) / ( align ) * ( align ) )
+
+
+// =======================
+// Types
+// =======================
+
+typedef struct
+{
+   unsigned long count[ NBUCKETS ];  /* samples per bucket               */
+   double        bytes[ NBUCKETS ];  /* sum of the samples per bucket    */
+   unsigned long total;              /* number of samples                */
+} histogram_t;
+
+typedef struct
+{
+   int    live;          /* block currently allocated                      */
+   int    size;          /* current payload size                           */
+   int    owner;         /* thread of the last alloc/realloc               */
+   int    reallocs;      /* reallocs since birth                           */
+   long   birth_op;      /* request index of the originating alloc         */
+   double birth_bytes;   /* cumulative bytes allocated at birth            */
+} object_t;
+
+typedef struct
+{
+   histogram_t alloc_sizes;
+   histogram_t realloc_sizes;
+   histogram_t life_ops;
+   histogram_t life_bytes;
+   histogram_t chains;
+
+   unsigned long allocs, reallocs, frees;
+   unsigned long realloc_grow, realloc_shrink;
+   unsigned long cross_frees;
+   unsigned long immortal;            /* objects still live at the end     */
+   int           max_chain;
+
+   double        bytes_allocated;     /* cumulative alloc+realloc bytes    */
+   double        live_payload;
+   double        peak_payload;
+   long          peak_op;
+   double        live_blocks[ 2 ];    /* [0] aligned only, [1] with tags   */
+   double        peak_blocks[ 2 ];
+} analysis_t;
+
+
+// ==========================
+// Private Global Variables
+// ==========================
+
+static int align    = DEFAULT_ALIGN;
+static int overhead = DEFAULT_OVERHEAD;
+
+
+// ==========================
+// Histogram Helpers
+// ==========================
+
+/*
+ * bucket_of - log2 bucket of a value: 0 -> 0, 1 -> 1, [2,3] -> 2, [4,7] -> 3 ...
+ */
+static int bucket_of( double value )
+{
+   int bucket = 0;
+
+   while ( value >= 1.0 && bucket < NBUCKETS - 1 )
+   {
+      value /= 2.0;
+      ++bucket;
+   }
+
+   return bucket;
+}
+
+
+static void hist_add( histogram_t* h, double value )
+{
+   int b = bucket_of( value );
+
+   ++h->count[ b ];
+   h->bytes[ b ] += value;
+   ++h->total;
+}
+
+
+/*
+ * hist_print - print the non-empty buckets of a histogram
+ *
+ * show_sum selects whether the share of the summed values is printed too;
+ * it is meaningful for sizes but not for counts such as chain lengths.
+ */
+static void hist_print( const char* title, const char* unit, const histogram_t* h, int show_sum )
+{
+   unsigned long max_count = 0;
+   double        sum       = 0.0;
+   int           b;
+
+   printf( "\n  %s (%lu samples)\n", title, h->total );
+
+   if ( h->total == 0 )
+      return;
+
+   for ( b = 0; b < NBUCKETS; ++b )
+   {
+      if ( h->count[ b ] > max_count )
+         max_count = h->count[ b ];
+      sum += h->bytes[ b ];
+   }
+
+   for ( b = 0; b < NBUCKETS; ++b )
+   {
+      char   range[ 48 ];
+      double lo = ( b == 0 ) ? 0.0 : ( double )( 1UL << ( b - 1 ) );
+      double hi = ( b == 0 ) ? 0.0 : 2.0 * lo - 1.0;
+      int    width;
+      int    i;
+
+      if ( h->count[ b ] == 0 )
+         continue;
+
+      if ( b == NBUCKETS - 1 )
+         snprintf( range, sizeof( range ), ">= %.0f", lo );
+      else if ( lo == hi )
+         snprintf( range, sizeof( range ), "%.0f", lo );
+      else
+         snprintf( range, sizeof( range ), "%.0f-%.0f", lo, hi );
+
+      printf( "    %22s %-5s %10lu %6.2f%%", range, unit, h->count[ b ],
+              100.0 * h->count[ b ] / h->total );
+      if ( show_sum )
+         printf( " %6.2f%% vol", sum > 0.0 ? 100.0 * h->bytes[ b ] / sum : 0.0 );
+      printf( "  " );
+
+      width = ( int )( ( double )BAR_WIDTH * h->count[ b ] / max_count );
+      for ( i = 0; i < width; ++i )
+         putchar( '#' );
+      putchar( '\n' );
+   }
+}
+
+
+// ==========================
+// Analysis
+// ==========================
+
+/*
+ * block_bytes - bytes an ideal allocator reserves for a payload of size bytes
+ */
+static double block_bytes( int size, int tag_bytes )
+{
+   return ( double )ALIGN_UP( ( long )size + tag_bytes, align );
+}
+
+
+static void add_live( analysis_t* a, int size, int sign )
+{
+   a->live_payload     += sign * ( double )size;
+   a->live_blocks[ 0 ] += sign * block_bytes( size, 0 );
+   a->live_blocks[ 1 ] += sign * block_bytes( size, overhead );
+}
+
+
+static void end_life( analysis_t* a, object_t* obj, long op )
+{
+   hist_add( &a->life_ops, ( double )( op - obj->birth_op ) );
+   hist_add( &a->life_bytes, a->bytes_allocated - obj->birth_bytes );
+   hist_add( &a->chains, ( double )obj->reallocs );
+
+   if ( obj->reallocs > a->max_chain )
+      a->max_chain = obj->reallocs;
+}
+
+
+static void analyze( const trace_t* trace, analysis_t* a )
+{
+   object_t* objs = ( object_t* )Calloc( trace->num_ids > 0 ? trace->num_ids : 1, sizeof( object_t ) );
+   long      op;
+   int       i;
+
+   memset( a, 0, sizeof( *a ) );
+   a->peak_op = -1;
+
+   for ( op = 0; op < trace->num_ops; ++op )
+   {
+      const trace_op_t* p   = &trace->ops[ op ];
+      object_t*         obj = &objs[ p->index ];
+
+      switch ( p->type )
+      {
+         case ALLOC:
+            if ( obj->live )                  /* id reused without a free */
+            {
+               add_live( a, obj->size, -1 );
+               end_life( a, obj, op );
+            }
+            ++a->allocs;
+            hist_add( &a->alloc_sizes, p->size );
+            obj->live        = 1;
+            obj->size        = p->size;
+            obj->owner       = p->thread;
+            obj->reallocs    = 0;
+            obj->birth_op    = op;
+            obj->birth_bytes = a->bytes_allocated;
+            a->bytes_allocated += p->size;
+            add_live( a, p->size, +1 );
+            break;
+
+         case REALLOC:
+            ++a->reallocs;
+            hist_add( &a->realloc_sizes, p->size );
+            if ( obj->live )
+            {
+               if ( p->size > obj->size )
+                  ++a->realloc_grow;
+               else if ( p->size < obj->size )
+                  ++a->realloc_shrink;
+               add_live( a, obj->size, -1 );
+               ++obj->reallocs;
+            }
+            else                              /* realloc( NULL, size ) */
+            {
+               obj->live        = 1;
+               obj->reallocs    = 0;
+               obj->birth_op    = op;
+               obj->birth_bytes = a->bytes_allocated;
+            }
+            obj->size  = p->size;
+            obj->owner = p->thread;
+            a->bytes_allocated += p->size;
+            add_live( a, p->size, +1 );
+            break;
+
+         case FREE:
+            ++a->frees;
+            if ( !obj->live )
+               break;
+            if ( p->thread != obj->owner )
+               ++a->cross_frees;
+            add_live( a, obj->size, -1 );
+            end_life( a, obj, op );
+            obj->live = 0;
+            break;
+      }
+
+      if ( a->live_payload > a->peak_payload )
+      {
+         a->peak_payload = a->live_payload;
+         a->peak_op      = op;
+      }
+      for ( i = 0; i < 2; ++i )
+         if ( a->live_blocks[ i ] > a->peak_blocks[ i ] )
+            a->peak_blocks[ i ] = a->live_blocks[ i ];
+   }
+
+   for ( i = 0; i < trace->num_ids; ++i )
+      if ( objs[ i ].live )
+         ++a->immortal;
+
+   free( objs );
+}
+
+
+static void report( const char* filename, const trace_t* trace, const analysis_t* a )
+{
+   printf( "=== %s ===\n", filename );
+   printf( "  requests:            %d (%lu alloc, %lu realloc, %lu free)\n",
+           trace->num_ops, a->allocs, a->reallocs, a->frees );
+   printf( "  block ids:           %d\n", trace->num_ids );
+   printf( "  threads:             %d\n", trace->num_threads );
+   printf( "  bytes allocated:     %.0f\n", a->bytes_allocated );
+   printf( "  peak live payload:   %.0f bytes at request %ld\n", a->peak_payload, a->peak_op );
+   printf( "  never freed:         %lu objects\n", a->immortal );
+
+   printf( "  realloc chains:      max %d, %lu grow, %lu shrink, %lu same size\n",
+           a->max_chain, a->realloc_grow, a->realloc_shrink,
+           a->reallocs - a->realloc_grow - a->realloc_shrink );
+
+   printf( "  cross-thread frees:  %lu of %lu (%.2f%%)\n", a->cross_frees, a->frees,
+           a->frees ? 100.0 * a->cross_frees / a->frees : 0.0 );
+
+   printf( "  best utilization:    %.2f%% (align %d), %.2f%% (align %d + %d bytes/block)\n",
+           a->peak_blocks[ 0 ] > 0.0 ? 100.0 * a->peak_payload / a->peak_blocks[ 0 ] : 0.0, align,
+           a->peak_blocks[ 1 ] > 0.0 ? 100.0 * a->peak_payload / a->peak_blocks[ 1 ] : 0.0, align, overhead );
+
+   hist_print( "alloc request sizes", "B", &a->alloc_sizes, 1 );
+   hist_print( "realloc request sizes", "B", &a->realloc_sizes, 1 );
+   hist_print( "lifetime in requests", "ops", &a->life_ops, 0 );
+   hist_print( "lifetime in bytes allocated", "B", &a->life_bytes, 0 );
+   hist_print( "reallocs per object", "", &a->chains, 0 );
+   putchar( '\n' );
+}
+
+
+static void usage( const char* prog )
+{
+   fprintf( stderr, "usage: %s [-h] [-a <align>] [-o <overhead>] <tracefile>...\n", prog );
+   fprintf( stderr, "  -a <align>     payload alignment of the modelled allocator (default %d)\n", DEFAULT_ALIGN );
+   fprintf( stderr, "  -o <overhead>  per-block metadata bytes of the modelled allocator (default %d)\n", DEFAULT_OVERHEAD );
+   fprintf( stderr, "  -h             print this message\n" );
+}
+
+
+int main( int argc, char* argv[] )
+{
+   int c;
+
+   while ( ( c = getopt( argc, argv, "ha:o:" ) ) != -1 )
+   {
+      switch ( c )
+      {
+         case 'a':
+            align = atoi( optarg );
+            break;
+         case 'o':
+            overhead = atoi( optarg );
+            break;
+         case 'h':
+            usage( argv[ 0 ] );
+            exit( EXIT_SUCCESS );
+         default:
+            usage( argv[ 0 ] );
+            exit( EXIT_FAILURE );
+      }
+   }
+
+   if ( align <= 0 || overhead < 0 )
+      app_error( "tanalyze: alignment must be positive and overhead non-negative" );
+
+   if ( optind >= argc )
+   {
+      usage( argv[ 0 ] );
+      exit( EXIT_FAILURE );
+   }
+
+   for ( ; optind < argc; ++optind )
+   {
+      trace_t*   trace = read_trace( argv[ optind ] );
+      analysis_t a;
+
+      analyze( trace, &a );
+      report( argv[ optind ], trace, &a );
+      free_trace( trace );
+   }
+
+   return EXIT_SUCCESS;
+}
\ No newline at end of file
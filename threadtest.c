@@ -0,0 +1,124 @@
+/**
+ * @file    threadtest.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Hoard threadtest benchmark
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Source:  Berger et al., "Hoard: A Scalable Memory Allocator for
+ *          Multithreaded Applications", ASPLOS 2000
+ *
+ * A fixed amount of work is divided among the threads: each one
+ * repeatedly allocates its share of the objects and then frees them all.
+ * Objects never leave the thread that allocated them, so an allocator that
+ * scales should show near linear speedup.
+ *
+ * usage: threadtest [-h] [-a <allocator>] [-t <max threads>]
+ *                   [-i <iterations>] [-n <objects>] [-s <size>]
+ */
+#include "bench.h"
+#include "ftimer.h"
+#include "std_wrappers.h"
+
+#include <pthread.h>        // pthread_t
+#include <stdlib.h>         // atoi, exit, free
+
+#include <unistd.h>         // optarg
+
+
+// ==========================
+// Private Global Variables
+// ==========================
+
+static int iterations = 50;
+static int nobjects   = 5000;
+static int objsize    = 64;
+static int per_thread;
+
+
+// ==========================
+// Private Helper Functions
+// ==========================
+
+static void* worker( void* arg )
+{
+   char** objs = ( char** )Calloc( per_thread > 0 ? per_thread : 1, sizeof( char* ) );
+   int    i;
+   int    j;
+
+   ( void )arg;
+
+   for ( i = 0; i < iterations; ++i )
+   {
+      for ( j = 0; j < per_thread; ++j )
+      {
+         objs[ j ]      = bench_malloc( objsize );
+         objs[ j ][ 0 ] = ( char )j;
+      }
+
+      for ( j = 0; j < per_thread; ++j )
+         bench_free( objs[ j ] );
+   }
+
+   free( objs );
+   return NULL;
+}
+
+
+static bench_result_t run( int nthreads )
+{
+   pthread_t*     tids = ( pthread_t* )Calloc( nthreads, sizeof( pthread_t ) );
+   bench_result_t res;
+   double         start;
+   int            t;
+
+   per_thread = nobjects / nthreads;
+   start      = ftimer_now();
+
+   for ( t = 0; t < nthreads; ++t )
+      Pthread_create( &tids[ t ], NULL, worker, NULL );
+   for ( t = 0; t < nthreads; ++t )
+      Pthread_join( tids[ t ], NULL );
+
+   res.secs = ftimer_now() - start;
+   res.ops  = 2.0 * iterations * per_thread * nthreads;
+
+   free( tids );
+   return res;
+}
+
+
+int main( int argc, char* argv[] )
+{
+   const char* options = "[-i <iterations>] [-n <objects>] [-s <size>]";
+   const char* help    = "  -i <iterations>   allocate/free rounds (default 50)\n"
+                         "  -n <objects>      objects per round, divided among the threads (default 5000)\n"
+                         "  -s <size>         object size in bytes (default 64)\n";
+   int         c;
+
+   while ( ( c = bench_getopt( argc, argv, "hi:n:s:" ) ) != -1 )
+   {
+      switch ( c )
+      {
+         case 'i': iterations = atoi( optarg ); break;
+         case 'n': nobjects   = atoi( optarg ); break;
+         case 's': objsize    = atoi( optarg ); break;
+         case 'h':
+            bench_usage( argv[ 0 ], options, help );
+            exit( EXIT_SUCCESS );
+         default:
+            bench_usage( argv[ 0 ], options, help );
+            exit( EXIT_FAILURE );
+      }
+   }
+
+   if ( iterations < 1 || nobjects < 1 || objsize < 1 )
+      app_error( "threadtest: invalid parameters" );
+
+   bench_setup();
+   bench_scaling( "threadtest", run );
+
+   return EXIT_SUCCESS;
+}
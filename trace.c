@@ -0,0 +1,156 @@
+/**
+ * @file    trace.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Source file for trace.h
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    Adapted from CSAPP.
+ */
+#include "trace.h"
+#include "std_wrappers.h"
+
+#include <stdio.h>          // FILE, fgets, snprintf, sscanf
+#include <stdlib.h>         // free
+
+
+// =======================
+// Constants and Macros
+// =======================
+
+#define MAXLINE 1024        /* max length of a line in a trace file */
+
+
+// ==========================
+// Private Helper Functions
+// ==========================
+
+/*
+ * trace_error - report a malformed trace file and terminate
+ */
+static void trace_error( const char* filename, int lineno, const char* what )
+{
+   char msg[ MAXLINE ];
+
+   snprintf( msg, sizeof( msg ), "%s:%d: %s", filename, lineno, what );
+   app_error( msg );
+}
+
+
+/*
+ * read_header_field - read the next non-empty header line as an integer
+ */
+static int read_header_field( FILE* fp, const char* filename, int* lineno )
+{
+   char line[ MAXLINE ];
+   int  value;
+
+   while ( fgets( line, sizeof( line ), fp ) != NULL )
+   {
+      ++*lineno;
+
+      if ( sscanf( line, "%d", &value ) == 1 )
+         return value;
+   }
+
+   trace_error( filename, *lineno, "truncated trace header" );
+   return -1;
+}
+
+
+// ==========================
+// Public Functions
+// ==========================
+
+/*
+ * read_trace - read a trace file and store it in memory
+ *
+ * Return: a heap allocated trace; terminates the program on a malformed file
+ */
+trace_t* read_trace( const char* filename )
+{
+   FILE*    fp     = Fopen( filename, "r" );
+   trace_t* trace  = ( trace_t* )Malloc( sizeof( trace_t ) );
+   char     line[ MAXLINE ];
+   int      lineno = 0;
+   int      op     = 0;
+
+   trace->sugg_heapsize = read_header_field( fp, filename, &lineno );
+   trace->num_ids       = read_header_field( fp, filename, &lineno );
+   trace->num_ops       = read_header_field( fp, filename, &lineno );
+   trace->weight        = read_header_field( fp, filename, &lineno );
+   trace->num_threads   = 1;
+
+   if ( trace->num_ids < 0 || trace->num_ops < 0 )
+      trace_error( filename, lineno, "negative id or request count" );
+
+   trace->ops = ( trace_op_t* )Calloc( trace->num_ops > 0 ? trace->num_ops : 1, sizeof( trace_op_t ) );
+
+   while ( op < trace->num_ops && fgets( line, sizeof( line ), fp ) != NULL )
+   {
+      trace_op_t* p = &trace->ops[ op ];
+      char        type;
+      int         fields;
+
+      ++lineno;
+
+      if ( sscanf( line, " %c", &type ) != 1 )
+         continue;                                 /* blank line */
+
+      p->thread = 0;
+
+      switch ( type )
+      {
+         case 'a':
+         case 'r':
+            p->type = ( type == 'a' ) ? ALLOC : REALLOC;
+            fields  = sscanf( line, " %*c %d %d %d", &p->index, &p->size, &p->thread );
+            if ( fields < 2 )
+               trace_error( filename, lineno, "expected: a|r <id> <size> [thread]" );
+            if ( p->size < 0 )
+               trace_error( filename, lineno, "negative request size" );
+            break;
+
+         case 'f':
+            p->type = FREE;
+            p->size = 0;
+            fields  = sscanf( line, " %*c %d %d", &p->index, &p->thread );
+            if ( fields < 1 )
+               trace_error( filename, lineno, "expected: f <id> [thread]" );
+            break;
+
+         default:
+            trace_error( filename, lineno, "unknown request type" );
+      }
+
+      if ( p->index < 0 || p->index >= trace->num_ids )
+         trace_error( filename, lineno, "block id out of range" );
+      if ( p->thread < 0 )
+         trace_error( filename, lineno, "negative thread id" );
+      if ( p->thread >= trace->num_threads )
+         trace->num_threads = p->thread + 1;
+
+      ++op;
+   }
+
+   if ( op != trace->num_ops )
+      trace_error( filename, lineno, "fewer requests than the header announces" );
+
+   Fclose( fp );
+   return trace;
+}
+
+
+/*
+ * free_trace - release the storage of a trace read by read_trace
+ */
+void free_trace( trace_t* trace )
+{
+   if ( trace == NULL )
+      return;
+
+   free( trace->ops );
+   free( trace );
+}
\ No newline at end of file
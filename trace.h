@@ -0,0 +1,56 @@
+/**
+ * @file    trace.h
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Reader for allocator trace files
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Source:  Adapted from CSAPP (mdriver.c)
+ *
+ * A trace file has a four line header followed by one request per line:
+ *
+ *    <suggested heap size>   (ignored)
+ *    <number of block ids>
+ *    <number of requests>
+ *    <weight>                (ignored)
+ *    a <id> <size> [thread]  allocate <size> bytes and name the block <id>
+ *    r <id> <size> [thread]  reallocate block <id> to <size> bytes
+ *    f <id> [thread]         free block <id>
+ *
+ * The optional thread field identifies the thread that issued the request.
+ * Requests without one are attributed to thread 0.
+ */
+#ifndef __2026_10_18_TRACE_H__
+#define __2026_10_18_TRACE_H__
+
+typedef enum
+{
+   ALLOC,
+   FREE,
+   REALLOC
+} trace_op_type_t;
+
+typedef struct
+{
+   trace_op_type_t type;      /* type of request                        */
+   int             index;     /* block id the request refers to         */
+   int             size;      /* byte size of alloc/realloc request     */
+   int             thread;    /* thread that issued the request         */
+} trace_op_t;
+
+typedef struct
+{
+   int         sugg_heapsize; /* suggested heap size (unused)          */
+   int         num_ids;       /* number of distinct block ids          */
+   int         num_ops;       /* number of requests                    */
+   int         weight;        /* weight for this trace (unused)        */
+   int         num_threads;   /* highest thread id seen plus 1         */
+   trace_op_t* ops;           /* array of requests                     */
+} trace_t;
+
+trace_t* read_trace( const char* filename );
+void     free_trace( trace_t* trace );
+
+#endif  // __2026_10_18_TRACE_H__
\ No newline at end of file
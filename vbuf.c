@@ -0,0 +1,206 @@
+/**
+ * @file    vbuf.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Source file for vbuf.h
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The reservation is a PROT_NONE, MAP_NORESERVE mapping, which costs
+ * address space only. The committed prefix is made readable and writable
+ * with mprotect, at least COMMIT_MIN bytes and an eighth of what is
+ * already committed at a time, so the number of mprotect calls grows
+ * logarithmically with the buffer. A vbuf that needs more than it reserved
+ * asks mremap, without MREMAP_MAYMOVE, to double the reservation where it
+ * is.
+ */
+#define _GNU_SOURCE                 // mremap
+
+#include "vbuf.h"
+#include "memlib.h"
+#include "std_wrappers.h"
+
+#include <errno.h>          // ENOMEM, errno
+#include <stdint.h>         // uintptr_t
+#include <string.h>         // memcpy
+
+#include <sys/mman.h>       // madvise, mmap, mprotect, mremap, MADV_*, PROT_*, MAP_*
+
+
+// =======================
+// Constants and Macros
+// =======================
+
+#define DEFAULT_RESERVE ( ( size_t )1 << 30 )   /* reservation for a hint of 0   */
+#define COMMIT_MIN      ( 64 * 1024 )           /* least bytes committed at once */
+
+#define ALIGN_UP( x, a )  ( ( ( uintptr_t )( x ) + ( a ) - 1 ) & ~( ( uintptr_t )( a ) - 1 ) )
+
+
+// ==========================
+// Private Helper Functions
+// ==========================
+
+/*
+ * reserve_more - extend the reservation in place to hold at least need bytes
+ *
+ * Return: 0 on success, -1 with errno set if the addresses are taken or
+ *         doubling the reservation would wrap
+ */
+static int reserve_more( vbuf_t* b, size_t need )
+{
+   size_t len = b->reserved;
+   void*  p;
+
+   while ( len < need )
+   {
+      if ( len > ( size_t )-1 / 2 )
+      {
+         errno = ENOMEM;
+         return -1;
+      }
+      len *= 2;
+   }
+
+   p = mremap( b->data, b->reserved, len, 0 );
+   if ( p == MAP_FAILED )
+      return -1;
+
+   b->reserved = len;
+   return 0;
+}
+
+
+/*
+ * commit - make at least the first need bytes of the reservation writable
+ *
+ * Return: 0 on success, -1 with errno set
+ */
+static int commit( vbuf_t* b, size_t need )
+{
+   size_t step = b->committed / 8;
+   size_t end;
+
+   if ( need > b->reserved && reserve_more( b, need ) < 0 )
+      return -1;
+
+   if ( step < COMMIT_MIN )
+      step = COMMIT_MIN;
+
+   end = ALIGN_UP( need > b->committed + step ? need : b->committed + step, mem_pagesize() );
+   if ( end > b->reserved )
+      end = b->reserved;
+
+   if ( mprotect( b->data + b->committed, end - b->committed, PROT_READ | PROT_WRITE ) < 0 )
+      return -1;
+
+   b->committed = end;
+   return 0;
+}
+
+
+// ==========================
+// Public Functions
+// ==========================
+
+/*
+ * vbuf_init - reserve address space for a buffer of up to hint bytes, or
+ *             DEFAULT_RESERVE bytes for a hint of 0, and start it empty
+ *
+ * Return: 0 on success, -1 with errno set if mmap fails
+ */
+int vbuf_init( vbuf_t* b, size_t hint )
+{
+   size_t len = ALIGN_UP( hint ? hint : DEFAULT_RESERVE, mem_pagesize() );
+   void*  p   = mmap( NULL, len, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0 );
+
+   if ( p == MAP_FAILED )
+      return -1;
+
+   b->data      = ( char* )p;
+   b->len       = 0;
+   b->committed = 0;
+   b->reserved  = len;
+   return 0;
+}
+
+
+/*
+ * vbuf_extend - add n bytes to the end of the buffer, committing pages as
+ *               needed; their contents are zero or left from before a reset
+ *
+ * Return: the first of the new bytes, or NULL with errno set to ENOMEM if
+ *         the buffer cannot grow without moving
+ */
+void* vbuf_extend( vbuf_t* b, size_t n )
+{
+   char* p;
+
+   if ( n > ( size_t )-1 - b->len )
+   {
+      errno = ENOMEM;
+      return NULL;
+   }
+
+   if ( b->len + n > b->committed && commit( b, b->len + n ) < 0 )
+   {
+      errno = ENOMEM;
+      return NULL;
+   }
+
+   p       = b->data + b->len;
+   b->len += n;
+   return p;
+}
+
+
+/*
+ * vbuf_append - copy n bytes from src to the end of the buffer
+ *
+ * Return: where they were copied to, or NULL as for vbuf_extend
+ */
+void* vbuf_append( vbuf_t* b, const void* src, size_t n )
+{
+   void* p = vbuf_extend( b, n );
+
+   if ( p != NULL )
+      memcpy( p, src, n );
+
+   return p;
+}
+
+
+/*
+ * vbuf_reset - empty the buffer, keeping its reservation; with release
+ *              set the committed pages go back to the kernel and are
+ *              committed again as the buffer grows
+ */
+void vbuf_reset( vbuf_t* b, int release )
+{
+   b->len = 0;
+
+   if ( release && b->committed > 0 )
+   {
+      if ( madvise( b->data, b->committed, MADV_DONTNEED ) < 0
+           || mprotect( b->data, b->committed, PROT_NONE ) < 0 )
+         unix_error( "vbuf_reset: madvise or mprotect error" );
+
+      b->committed = 0;
+   }
+}
+
+
+/*
+ * vbuf_free - unmap the buffer and its reservation
+ */
+void vbuf_free( vbuf_t* b )
+{
+   if ( b->data != NULL )
+      Munmap( b->data, b->reserved );
+
+   b->data      = NULL;
+   b->len       = 0;
+   b->committed = 0;
+   b->reserved  = 0;
+}
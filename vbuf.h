@@ -0,0 +1,42 @@
+/**
+ * @file    vbuf.h
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   Growable buffers in a virtual address range of their own
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * A vbuf reserves address space for its largest expected size up front,
+ * from a caller hint, and commits pages of it as it grows. Growing never
+ * moves or copies the bytes already in the buffer, so pointers into it
+ * stay valid, which suits logs and column buffers whose final size is
+ * unknown. Pages are only backed by memory once they are written.
+ *
+ * A vbuf that outgrows its reservation tries to extend the reservation in
+ * place; if the addresses above it are taken, the append fails rather
+ * than move the buffer.
+ *
+ * vbufs are mappings of their own, independent of the memlib heap and its
+ * limits; they need no mem_init().
+ */
+#ifndef __2026_10_18_VBUF_H__
+#define __2026_10_18_VBUF_H__
+
+#include <stddef.h>            // size_t
+
+typedef struct
+{
+   char*  data;        /* start of the buffer; never moves                  */
+   size_t len;         /* bytes in use                                       */
+   size_t committed;   /* bytes readable and writable, a multiple of pages  */
+   size_t reserved;    /* bytes of address space reserved                    */
+} vbuf_t;
+
+int   vbuf_init( vbuf_t* b, size_t hint );
+void* vbuf_extend( vbuf_t* b, size_t n );
+void* vbuf_append( vbuf_t* b, const void* src, size_t n );
+void  vbuf_reset( vbuf_t* b, int release );
+void  vbuf_free( vbuf_t* b );
+
+#endif  // __2026_10_18_VBUF_H__
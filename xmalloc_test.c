@@ -0,0 +1,249 @@
+/**
+ * @file    xmalloc_test.c
+ * @author  William Weston (wjtWeston@protonmail.com)
+ * @brief   xmalloc-test benchmark: producer/consumer allocation
+ * @version 0.1
+ * @date    2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Source:  Lever and Boreham, "malloc() Performance in a Multithreaded
+ *          Linux Environment", USENIX 2000
+ *
+ * The threads form a ring. Each one allocates a batch of blocks of random
+ * size, passes the batch to the next thread and frees the batches it has
+ * received from the previous one, so every block is freed by a thread
+ * other than the one that allocated it (with a single thread, by itself).
+ * A thread whose successor already has MAX_PENDING batches waiting frees
+ * its own queue and yields until there is room, which bounds the memory
+ * in flight. The benchmark runs for a fixed time and counts blocks.
+ *
+ * usage: xmalloc-test [-h] [-a <allocator>] [-t <max threads>]
+ *                     [-s <secs>] [-b <batch>] [-M <max size>]
+ */
+#include "bench.h"
+#include "ftimer.h"
+#include "std_wrappers.h"
+
+#include <pthread.h>        // pthread_t, pthread_mutex_t
+#include <sched.h>          // sched_yield
+#include <stdatomic.h>      // atomic_int, atomic_load, atomic_store
+#include <stdlib.h>         // atof, atoi, exit, free
+
+#include <unistd.h>         // optarg, usleep
+
+
+// =======================
+// Constants and Macros
+// =======================
+
+#define MAX_BATCH   1024    /* largest batch size accepted by -b           */
+#define MAX_PENDING 8       /* batches a thread may have waiting for it    */
+
+
+// =======================
+// Types
+// =======================
+
+typedef struct batch batch_t;
+
+struct batch
+{
+   batch_t* next;
+   void*    blocks[ MAX_BATCH ];
+};
+
+typedef struct
+{
+   pthread_mutex_t lock;
+   batch_t*        head;       /* batches waiting to be freed  */
+   int             pending;
+   long            ops;        /* blocks allocated and freed   */
+   unsigned        seed;
+   int             id;
+} ring_slot_t;
+
+
+// ==========================
+// Private Global Variables
+// ==========================
+
+static double       nsecs    = 1.0;
+static int          batch    = 100;
+static int          max_size = 120;
+
+static ring_slot_t* ring;
+static int          ring_size;
+static atomic_int   stop;
+
+
+// ==========================
+// Private Helper Functions
+// ==========================
+
+/*
+ * drain - free every batch queued for a ring slot
+ */
+static long drain( ring_slot_t* slot )
+{
+   batch_t* b;
+   long     n = 0;
+   int      i;
+
+   pthread_mutex_lock( &slot->lock );
+   b             = slot->head;
+   slot->head    = NULL;
+   slot->pending = 0;
+   pthread_mutex_unlock( &slot->lock );
+
+   while ( b != NULL )
+   {
+      batch_t* next = b->next;
+
+      for ( i = 0; i < batch; ++i )
+         bench_free( b->blocks[ i ] );
+      bench_free( b );
+
+      n += batch;
+      b  = next;
+   }
+
+   return n;
+}
+
+
+/*
+ * push - queue a batch for a ring slot
+ *
+ * Return: 1 if the batch was queued, 0 if the slot is full
+ */
+static int push( ring_slot_t* slot, batch_t* b )
+{
+   int ok;
+
+   pthread_mutex_lock( &slot->lock );
+   if ( ( ok = ( slot->pending < MAX_PENDING ) ) )
+   {
+      b->next    = slot->head;
+      slot->head = b;
+      ++slot->pending;
+   }
+   pthread_mutex_unlock( &slot->lock );
+
+   return ok;
+}
+
+
+static void* worker( void* arg )
+{
+   ring_slot_t* self = ( ring_slot_t* )arg;
+   ring_slot_t* next = &ring[ ( self->id + 1 ) % ring_size ];
+   int          i;
+
+   while ( !atomic_load( &stop ) )
+   {
+      batch_t* b = bench_malloc( sizeof( batch_t ) );
+
+      for ( i = 0; i < batch; ++i )
+      {
+         size_t size = 1 + bench_rand( &self->seed ) % ( unsigned )max_size;
+
+         b->blocks[ i ] = bench_malloc( size );
+         *( char* )b->blocks[ i ] = ( char )i;
+      }
+
+      while ( !push( next, b ) )
+      {
+         self->ops += drain( self );
+         if ( atomic_load( &stop ) )
+         {
+            for ( i = 0; i < batch; ++i )
+               bench_free( b->blocks[ i ] );
+            bench_free( b );
+            return NULL;
+         }
+         sched_yield();
+      }
+
+      self->ops += drain( self );
+   }
+
+   return NULL;
+}
+
+
+static bench_result_t run( int nthreads )
+{
+   pthread_t*     tids = ( pthread_t* )Calloc( nthreads, sizeof( pthread_t ) );
+   bench_result_t res  = { 0.0, 0.0 };
+   double         start;
+   int            t;
+
+   ring      = ( ring_slot_t* )Calloc( nthreads, sizeof( ring_slot_t ) );
+   ring_size = nthreads;
+
+   for ( t = 0; t < nthreads; ++t )
+   {
+      pthread_mutex_init( &ring[ t ].lock, NULL );
+      ring[ t ].seed = 88675123u + t;
+      ring[ t ].id   = t;
+   }
+
+   atomic_store( &stop, 0 );
+   start = ftimer_now();
+
+   for ( t = 0; t < nthreads; ++t )
+      Pthread_create( &tids[ t ], NULL, worker, &ring[ t ] );
+
+   usleep( ( useconds_t )( nsecs * 1e6 ) );
+   atomic_store( &stop, 1 );
+
+   for ( t = 0; t < nthreads; ++t )
+      Pthread_join( tids[ t ], NULL );
+
+   res.secs = ftimer_now() - start;
+
+   for ( t = 0; t < nthreads; ++t )
+   {
+      res.ops += ring[ t ].ops + drain( &ring[ t ] );
+      pthread_mutex_destroy( &ring[ t ].lock );
+   }
+
+   free( ring );
+   free( tids );
+   return res;
+}
+
+
+int main( int argc, char* argv[] )
+{
+   const char* options = "[-s <secs>] [-b <batch>] [-M <max size>]";
+   const char* help    = "  -s <secs>         run time per thread count (default 1)\n"
+                         "  -b <batch>        blocks per batch, at most 1024 (default 100)\n"
+                         "  -M <max size>     largest block size (default 120)\n";
+   int         c;
+
+   while ( ( c = bench_getopt( argc, argv, "hs:b:M:" ) ) != -1 )
+   {
+      switch ( c )
+      {
+         case 's': nsecs    = atof( optarg ); break;
+         case 'b': batch    = atoi( optarg ); break;
+         case 'M': max_size = atoi( optarg ); break;
+         case 'h':
+            bench_usage( argv[ 0 ], options, help );
+            exit( EXIT_SUCCESS );
+         default:
+            bench_usage( argv[ 0 ], options, help );
+            exit( EXIT_FAILURE );
+      }
+   }
+
+   if ( batch < 1 || batch > MAX_BATCH || max_size < 1 )
+      app_error( "xmalloc-test: invalid parameters" );
+
+   bench_setup();
+   bench_scaling( "xmalloc-test", run );
+
+   return EXIT_SUCCESS;
+}